@@ -0,0 +1,443 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Benchmarks for timing collectors and the full    ##
+    ## pipeline against fixture trees                   ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#include "src/arena.h"
+#include "src/cpu.h"
+#include "src/de-wm.h"
+#include "src/general.h"
+#include "src/globals.h"
+#include "src/gpu.h"
+#include "src/io.h"
+#include "src/os.h"
+#include "src/packages.h"
+#include "src/pciids.h"
+#include "src/process.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+
+
+typedef struct {
+    const char *name;
+    // Makes a single call of whatever is being benchmarked
+    void (*run)(const int);
+} BENCHMARK;
+
+
+
+#define BENCH_DEFAULT_ITERATIONS    1000
+#define BENCH_DEFAULT_SYSROOT       "bench/fixture"
+#define BENCH_DEFAULT_CPUINFOS      "cpuinfo-ds"
+#define BENCH_MAX_CPUINFOS          500
+#define BENCH_WRAP_LINES            64
+#define BENCH_GPUS_PER_CALL         4
+
+// A spread of vendors, generations and revisions, including some with no
+// pci.ids entry at all
+static const GPU_IDS BENCH_GPUS[] = {
+    { NULL, 0x1002, 0x4158, 0x00, "" },
+    { NULL, 0x1002, 0x6779, -1, "" },
+    { NULL, 0x1002, 0x6780, 0x00, "" },
+    { NULL, 0x1002, 0x73bf, 0xc1, "" },
+    { NULL, 0x1002, 0x7480, 0xc1, "" },
+    { NULL, 0x10de, 0x0110, -1, "" },
+    { NULL, 0x10de, 0x0624, -1, "" },
+    { NULL, 0x10de, 0x13c0, 0xa1, "" },
+    { NULL, 0x10de, 0x1f07, -1, "" },
+    { NULL, 0x10de, 0x2702, -1, "" },
+    { NULL, 0x102b, 0x0525, -1, "" },
+    { NULL, 0x1234, 0x1111, 0x02, "" },
+    { NULL, 0x15ad, 0x0405, -1, "" },
+    { NULL, 0x8086, 0x3e92, 0x00, "" },
+    { NULL, 0x8086, 0x7d55, 0x08, "" },
+    { NULL, 0x5333, 0x8811, -1, "" }
+};
+static const int BENCH_GPUS_LEN = sizeof(BENCH_GPUS) / sizeof(BENCH_GPUS[0]);
+
+
+
+// Allocations made through the wrapped allocator functions
+static long long ALLOCATIONS = 0;
+static char CPUINFOS[BENCH_MAX_CPUINFOS][PATH_MAX];
+static int CPUINFOS_LEN = 0;
+static char *BENCH_OS = NULL;
+// Holds BENCH_OS for the whole run, and what a single call allocates
+static MEM_ARENA BENCH_ARENA;
+static MEM_ARENA BENCH_CALL_ARENA;
+static char *BENCH_OUTPUT = NULL;
+static char BENCH_SYSROOT_ARG[PATH_MAX + 16];
+// Desktop the getWM benchmark acts as if it is running under
+static char BENCH_DESKTOP[] = "XFCE";
+
+
+
+// Every allocation is counted by linking with -Wl,--wrap for each of these
+void *__real_malloc(size_t);
+void *__real_calloc(size_t, size_t);
+void *__real_realloc(void *, size_t);
+char *__real_strdup(const char *);
+char *__real_strndup(const char *, size_t);
+
+void *__wrap_malloc(size_t size)
+{
+    __atomic_add_fetch(&ALLOCATIONS, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    __atomic_add_fetch(&ALLOCATIONS, 1, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    __atomic_add_fetch(&ALLOCATIONS, 1, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+char *__wrap_strdup(const char *str)
+{
+    __atomic_add_fetch(&ALLOCATIONS, 1, __ATOMIC_RELAXED);
+    return __real_strdup(str);
+}
+
+char *__wrap_strndup(const char *str, size_t size)
+{
+    __atomic_add_fetch(&ALLOCATIONS, 1, __ATOMIC_RELAXED);
+    return __real_strndup(str, size);
+}
+
+// main() from src/main.c, renamed when building the benchmark
+int shorkfetchMain(int, char *[]);
+
+
+
+static void benchGetCPU(const int i)
+{
+    char *gpuFromCPU = NULL;
+    CPU_DATA *cpu = getCPU(CPUINFOS[i % CPUINFOS_LEN], &gpuFromCPU);
+    free(interpretCPU(cpu));
+    freeCPU(cpu);
+    free(gpuFromCPU);
+}
+
+static void benchInterpretGPU(const int i)
+{
+    GPU_IDS gpu = BENCH_GPUS[i % BENCH_GPUS_LEN];
+    free(interpretGPU(&gpu, BENCH_OS));
+}
+
+static void benchInterpretGPUs(const int i)
+{
+    GPU_IDS gpus[BENCH_GPUS_PER_CALL];
+    for (int j = 0; j < BENCH_GPUS_PER_CALL; j++)
+        gpus[j] = BENCH_GPUS[(i + j) % BENCH_GPUS_LEN];
+
+    char **names = interpretGPUs(gpus, BENCH_GPUS_PER_CALL, BENCH_OS);
+    for (int j = 0; names && j < BENCH_GPUS_PER_CALL; j++)
+        free(names[j]);
+    free(names);
+}
+
+static void benchGetGPUs(const int i)
+{
+    (void)i;
+    int noGPUs = 0;
+    free(getGPUs(&noGPUs));
+}
+
+static void benchGetPackages(const int i)
+{
+    (void)i;
+    getPackages(&BENCH_CALL_ARENA, BENCH_OS);
+    freeArena(&BENCH_CALL_ARENA);
+}
+
+static void benchGetWM(const int i)
+{
+    (void)i;
+    // Every call should pay for scanning /proc, as a real run does, which
+    // only happens with a display
+    freeProcTable();
+    X11_PRESENT = 1;
+    XDG_CURRENT_DESKTOP = BENCH_DESKTOP;
+    char *de = getDE(&BENCH_CALL_ARENA);
+    getWM(&BENCH_CALL_ARENA, &de);
+    freeArena(&BENCH_CALL_ARENA);
+}
+
+static void benchWordWrap(const int i)
+{
+    WORD_WRAPPED *wrapped = wordWrap(BENCH_OUTPUT, 40 + i % 40,
+        "          ", 1, 0);
+    if (wrapped)
+    {
+        free(wrapped->str);
+        free(wrapped);
+    }
+}
+
+static void benchMain(const int i)
+{
+    char *argv[] = { "shorkfetch", BENCH_SYSROOT_ARG, "-ni",
+        i % 2 ? "-co" : "-m=n", NULL };
+
+    // main() only ever turns these on, as a process runs it once, so they
+    // are put back to their defaults for every call to really alternate
+    COMPACT = 0;
+    SHORK_LINE = 0;
+    SHOW_SHORK = 1;
+    shorkfetchMain(4, argv);
+}
+
+static const BENCHMARK BENCHMARKS[] = {
+    { "getCPU",         benchGetCPU },
+    { "getGPUs",        benchGetGPUs },
+    { "interpretGPU",   benchInterpretGPU },
+    { "interpretGPUs",  benchInterpretGPUs },
+    { "getPackages",    benchGetPackages },
+    { "getWM",          benchGetWM },
+    { "wordWrap",       benchWordWrap },
+    { "main",           benchMain }
+};
+static const int BENCHMARKS_LEN = sizeof(BENCHMARKS) /
+    sizeof(BENCHMARKS[0]);
+
+
+
+/**
+ * Adds every .cpuinfo file in a directory (and its immediate subdirectories)
+ * to the getCPU benchmark's inputs.
+ * @param dir Path to directory
+ * @param depth How many levels of subdirectories to still look in
+ */
+static void findCPUInfos(const char *dir, const int depth)
+{
+    DIR *dirStream = opendir(dir);
+    if (!dirStream) return;
+
+    struct dirent *entry;
+    while ((entry = readdir(dirStream)) != NULL &&
+        CPUINFOS_LEN < BENCH_MAX_CPUINFOS)
+    {
+        if (entry->d_name[0] == '.') continue;
+
+        char path[PATH_MAX];
+        snprintf(path, PATH_MAX, "%s/%s", dir, entry->d_name);
+
+        if (entry->d_type == DT_DIR)
+        {
+            if (depth > 0 && strcmp(entry->d_name, "excluded") != 0)
+                findCPUInfos(path, depth - 1);
+            continue;
+        }
+
+        const char *ext = strrchr(entry->d_name, '.');
+        if (ext && strcmp(ext, ".cpuinfo") == 0)
+            snprintf(CPUINFOS[CPUINFOS_LEN++], PATH_MAX, "%s", path);
+    }
+    closedir(dirStream);
+}
+
+/**
+ * qsort comparator for call times.
+ */
+static int compareTimes(const void *a, const void *b)
+{
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Runs a benchmark and prints a line of its results.
+ * @param bench Benchmark to run
+ * @param iterations Number of calls to make
+ * @param times Buffer of at least iterations for each call's time
+ */
+static void runBenchmark(const BENCHMARK *bench, const int iterations,
+    long long *times)
+{
+    // Keep the full pipeline's output out of the results
+    int savedStdout = -1;
+    if (bench->run == benchMain)
+    {
+        fflush(stdout);
+        savedStdout = dup(STDOUT_FILENO);
+        int devNull = open("/dev/null", O_WRONLY);
+        if (devNull != -1)
+        {
+            dup2(devNull, STDOUT_FILENO);
+            close(devNull);
+        }
+    }
+
+    long long allocations = ALLOCATIONS;
+    for (int i = 0; i < iterations; i++)
+    {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bench->run(i);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        times[i] = (end.tv_sec - start.tv_sec) * 1000000000LL +
+            (end.tv_nsec - start.tv_nsec);
+    }
+    allocations = ALLOCATIONS - allocations;
+
+    if (savedStdout != -1)
+    {
+        fflush(stdout);
+        dup2(savedStdout, STDOUT_FILENO);
+        close(savedStdout);
+    }
+
+    qsort(times, iterations, sizeof(long long), compareTimes);
+    printf("%-14s %8d %10.1f %10.1f %10.1f %10.1f %12.1f\n", bench->name,
+        iterations, times[0] / 1000.0, times[iterations / 2] / 1000.0,
+        times[(int)((iterations - 1) * 0.99)] / 1000.0,
+        times[iterations - 1] / 1000.0, (double)allocations / iterations);
+}
+
+static void showHelp(void)
+{
+    printf("Usage: shorkfetch-bench [OPTIONS] [BENCHMARK...]\n\n");
+    printf("Options:\n");
+    printf("-c DIR      Directory of .cpuinfo files for getCPU (default "
+        "\"%s\"; the sysroot's /proc/cpuinfo if missing)\n",
+        BENCH_DEFAULT_CPUINFOS);
+    printf("-h          Displays help information and exits\n");
+    printf("-n COUNT    Number of calls per benchmark (default %d)\n",
+        BENCH_DEFAULT_ITERATIONS);
+    printf("-s DIR      Fixture tree to use as the sysroot (default "
+        "\"%s\"; \"/\" for the live system)\n\n", BENCH_DEFAULT_SYSROOT);
+    printf("Benchmarks:");
+    for (int i = 0; i < BENCHMARKS_LEN; i++)
+        printf(" %s", BENCHMARKS[i].name);
+    printf("\n");
+}
+
+
+
+int main(int argc, char *argv[])
+{
+    TERM_SIZE.ws_col = 80;
+    TERM_SIZE.ws_row = 24;
+
+    const char *cpuInfoDir = BENCH_DEFAULT_CPUINFOS;
+    const char *sysroot = BENCH_DEFAULT_SYSROOT;
+    int iterations = BENCH_DEFAULT_ITERATIONS;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:hn:s:")) != -1)
+    {
+        if (opt == 'c')
+            cpuInfoDir = optarg;
+        else if (opt == 'n')
+            iterations = atoi(optarg);
+        else if (opt == 's')
+            sysroot = optarg;
+        else
+        {
+            showHelp();
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (iterations < 1)
+    {
+        printf("ERROR: at least one call per benchmark is needed\n");
+        return 1;
+    }
+    if (!setSysroot(strcmp(sysroot, "/") == 0 ? NULL : sysroot))
+    {
+        printf("ERROR: sysroot \"%s\" is not a directory\n", sysroot);
+        return 1;
+    }
+    snprintf(BENCH_SYSROOT_ARG, sizeof(BENCH_SYSROOT_ARG), "--sysroot=%s",
+        strcmp(sysroot, "/") == 0 ? "" : sysroot);
+
+    // shorkfetch.conf is read from (and the cache kept in) the real HOME,
+    // so a fixture's home is used instead; having no config, every machine
+    // runs the main benchmark with the defaults
+    char home[PATH_MAX];
+    if (strcmp(sysroot, "/") != 0 && realpath(sysroot, home))
+    {
+        char path[PATH_MAX + 32];
+        snprintf(path, sizeof(path), "%s/home/shork", home);
+        setenv("HOME", path, 1);
+        snprintf(path, sizeof(path), "%s/home/shork/.cache", home);
+        setenv("XDG_CACHE_HOME", path, 1);
+    }
+    HOME = getenv("HOME");
+
+    findCPUInfos(cpuInfoDir, 1);
+    if (CPUINFOS_LEN == 0)
+        snprintf(CPUINFOS[CPUINFOS_LEN++], PATH_MAX, "/proc/cpuinfo");
+
+    struct utsname u;
+    int uStatus = uname(&u);
+    initArena(&BENCH_ARENA);
+    initArena(&BENCH_CALL_ARENA);
+    BENCH_OS = getOS(&BENCH_ARENA, u, uStatus);
+
+    // Something like a full normal mode output, with escape codes
+    int outputLen = BENCH_WRAP_LINES * 96 + 1;
+    BENCH_OUTPUT = malloc(outputLen);
+    if (!BENCH_OUTPUT) return 1;
+    BENCH_OUTPUT[0] = '\0';
+    for (int i = 0, pos = 0; i < BENCH_WRAP_LINES; i++)
+        pos += snprintf(BENCH_OUTPUT + pos, outputLen - pos,
+            "\033[1;36mField %02d:\033[0m %s value with a few more words "
+            "%d\n", i, i % 3 ? "Long" : "Short", i * 37);
+
+    long long *times = malloc(iterations * sizeof(long long));
+    if (!times) return 1;
+
+    printf("%d cpuinfo file(s), %d GPU ID(s), sysroot \"%s\"\n\n",
+        CPUINFOS_LEN, BENCH_GPUS_LEN, sysroot);
+    printf("%-14s %8s %10s %10s %10s %10s %12s\n", "Benchmark", "Calls",
+        "Min (us)", "p50 (us)", "p99 (us)", "Max (us)", "Allocs/call");
+
+    for (int i = 0; i < BENCHMARKS_LEN; i++)
+    {
+        // Only run the named benchmarks if any were given
+        int selected = optind >= argc;
+        for (int j = optind; j < argc; j++)
+            if (strcmp(argv[j], BENCHMARKS[i].name) == 0)
+                selected = 1;
+        if (!selected) continue;
+
+        runBenchmark(&BENCHMARKS[i], iterations, times);
+
+        // main() drops the sysroot when it is done
+        setSysroot(strcmp(sysroot, "/") == 0 ? NULL : sysroot);
+    }
+
+    free(times);
+    free(BENCH_OUTPUT);
+    freeArena(&BENCH_ARENA);
+    freeProcTable();
+    freePCIIDs();
+    setSysroot(NULL);
+
+    return 0;
+}
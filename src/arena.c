@@ -0,0 +1,146 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to handing out       ##
+    ## memory that is all freed together at the end of  ##
+    ## a run                                            ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+
+// Where a block's allocations start, after its header
+#define ARENA_HEADER_SIZE \
+    ((sizeof(ARENA_BLOCK) + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN)
+
+
+
+/**
+ * Allocates memory that lives until the arena is freed.
+ * @param arena Arena to allocate from
+ * @param size Number of bytes needed
+ * @return Pointer to the allocated memory; NULL if out of memory
+ */
+void *arenaAlloc(MEM_ARENA *arena, const size_t size)
+{
+    if (!arena)
+        return NULL;
+    size_t needed = (size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+    if (needed == 0)
+        needed = ARENA_ALIGN;
+
+    pthread_mutex_lock(&arena->lock);
+
+    ARENA_BLOCK *block = arena->head;
+    if (!block || block->size - block->used < needed)
+    {
+        // Allocations too big for a normal block get one of their own, which
+        // goes behind the newest block so its space isn't wasted
+        size_t blockSize = ARENA_BLOCK_SIZE;
+        if (needed > blockSize - ARENA_HEADER_SIZE)
+            blockSize = ARENA_HEADER_SIZE + needed;
+
+        ARENA_BLOCK *fresh = malloc(blockSize);
+        if (!fresh)
+        {
+            pthread_mutex_unlock(&arena->lock);
+            return NULL;
+        }
+        fresh->size = blockSize;
+        fresh->used = ARENA_HEADER_SIZE;
+
+        if (block && blockSize != ARENA_BLOCK_SIZE)
+        {
+            fresh->prev = block->prev;
+            block->prev = fresh;
+        }
+        else
+        {
+            fresh->prev = block;
+            arena->head = fresh;
+        }
+        block = fresh;
+    }
+
+    void *result = (char *)block + block->used;
+    block->used += needed;
+
+    pthread_mutex_unlock(&arena->lock);
+    return result;
+}
+
+/**
+ * @param arena Arena to allocate from
+ * @param str String to copy
+ * @return Copy of the string that lives until the arena is freed; NULL if
+ *         the string is NULL or out of memory
+ */
+char *arenaStrdup(MEM_ARENA *arena, const char *str)
+{
+    if (!str)
+        return NULL;
+
+    size_t len = strlen(str);
+    char *result = arenaAlloc(arena, len + 1);
+    if (result)
+        memcpy(result, str, len + 1);
+    return result;
+}
+
+/**
+ * Moves a separately allocated string into an arena, so it is freed along
+ * with the arena instead of on its own.
+ * @param arena Arena to move the string into
+ * @param str String to move, which is freed
+ * @return Copy of the string that lives until the arena is freed; NULL if
+ *         the string is NULL or out of memory
+ */
+char *arenaTake(MEM_ARENA *arena, char *str)
+{
+    char *result = arenaStrdup(arena, str);
+    free(str);
+    return result;
+}
+
+/**
+ * Frees everything allocated from an arena at once. It is left empty and can
+ * still be used afterwards.
+ * @param arena Arena to free
+ */
+void freeArena(MEM_ARENA *arena)
+{
+    if (!arena)
+        return;
+
+    pthread_mutex_lock(&arena->lock);
+    while (arena->head)
+    {
+        ARENA_BLOCK *prev = arena->head->prev;
+        free(arena->head);
+        arena->head = prev;
+    }
+    pthread_mutex_unlock(&arena->lock);
+}
+
+/**
+ * Prepares an arena for use. Nothing is allocated until the first call to
+ * arenaAlloc.
+ * @param arena Arena to prepare
+ */
+void initArena(MEM_ARENA *arena)
+{
+    arena->head = NULL;
+    pthread_mutex_init(&arena->lock, NULL);
+}
@@ -0,0 +1,56 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to handing out       ##
+    ## memory that is all freed together at the end of  ##
+    ## a run                                            ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#ifndef ARENA
+#define ARENA
+
+#include <pthread.h>
+#include <stddef.h>
+
+
+
+// Size of each block allocations are carved out of (larger ones get a block
+// of their own)
+#define ARENA_BLOCK_SIZE    4096
+// Alignment of every allocation
+#define ARENA_ALIGN         (2 * sizeof(void *))
+
+
+
+typedef struct ARENA_BLOCK {
+    // Block that was filled up before this one
+    struct ARENA_BLOCK *prev;
+    size_t size;
+    size_t used;
+} ARENA_BLOCK;
+
+// Memory for values that live until the end of the run. Allocations are taken
+// in order from the newest block, and are only ever freed all together.
+// Collectors on different threads may share one arena.
+typedef struct {
+    ARENA_BLOCK *head;
+    pthread_mutex_t lock;
+} MEM_ARENA;
+
+
+
+void *arenaAlloc(MEM_ARENA *, const size_t);
+char *arenaStrdup(MEM_ARENA *, const char *);
+char *arenaTake(MEM_ARENA *, char *);
+void freeArena(MEM_ARENA *);
+void initArena(MEM_ARENA *);
+
+#endif
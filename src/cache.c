@@ -0,0 +1,397 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to caching slow to   ##
+    ## find values between runs in the same boot        ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#include "arena.h"
+#include "cache.h"
+#include "globals.h"
+#include "io.h"
+
+#include <dirent.h>
+#include <linux/limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+
+// Current boot's ID; empty if unknown, which disables the cache
+static char BOOT_ID[BOOT_ID_LEN] = "";
+static CACHE_ENTRY *ENTRIES = NULL;
+static int ENTRIES_LEN = 0;
+// Flags if any entry has changed since the cache file was read
+static int CACHE_DIRTY = 0;
+// Guards the entries, as collectors may use the cache from worker threads
+static pthread_mutex_t CACHE_LOCK = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+/**
+ * @param key Name of the cached value
+ * @return The entry with the given key; NULL if there is none
+ */
+static CACHE_ENTRY *findEntry(const char *key)
+{
+    for (int i = 0; i < ENTRIES_LEN; i++)
+        if (strcmp(ENTRIES[i].key, key) == 0)
+            return &ENTRIES[i];
+    return NULL;
+}
+
+/**
+ * Frees the key, stamp and value(s) of an entry.
+ * @param entry Entry to free the contents of
+ */
+static void freeEntry(CACHE_ENTRY *entry)
+{
+    free(entry->key);
+    free(entry->stamp);
+    for (int i = 0; i < entry->count; i++)
+        free(entry->values[i]);
+    free(entry->values);
+}
+
+/**
+ * Adds a new, empty entry to the end of the cache.
+ * @param key Name of the cached value
+ * @param stamp Summary of the value's sources
+ * @return The new entry; NULL if out of memory
+ */
+static CACHE_ENTRY *addEntry(const char *key, const char *stamp)
+{
+    CACHE_ENTRY *grown = realloc(ENTRIES,
+        (ENTRIES_LEN + 1) * sizeof(CACHE_ENTRY));
+    if (!grown) return NULL;
+    ENTRIES = grown;
+
+    CACHE_ENTRY *entry = &ENTRIES[ENTRIES_LEN++];
+    entry->key = strdup(key);
+    entry->stamp = strdup(stamp);
+    entry->values = NULL;
+    entry->count = 0;
+    return entry;
+}
+
+/**
+ * Appends a value line to an entry.
+ * @param entry Entry to add to
+ * @param value Value line to add a copy of
+ */
+static void addValue(CACHE_ENTRY *entry, const char *value)
+{
+    char **grown = realloc(entry->values, (entry->count + 1) * sizeof(char *));
+    if (!grown) return;
+    entry->values = grown;
+    entry->values[entry->count++] = strdup(value);
+}
+
+
+
+/**
+ * Frees the in-memory copy of the cache.
+ */
+void freeCache(void)
+{
+    for (int i = 0; i < ENTRIES_LEN; i++)
+        freeEntry(&ENTRIES[i]);
+    free(ENTRIES);
+    ENTRIES = NULL;
+    ENTRIES_LEN = 0;
+    CACHE_DIRTY = 0;
+}
+
+/**
+ * Looks up a cached value, only giving it back if it was found from the same
+ * state of its sources as now.
+ * @param arena Arena to allocate the copy of the value from
+ * @param key Name of the cached value
+ * @param stamp Summary of the value's sources as they are now
+ * @param values Receives a copy of the value line(s); NULL if there are none
+ * @return Number of value lines if found; -1 if not cached or out-of-date
+ */
+int getCached(MEM_ARENA *arena, const char *key, const char *stamp,
+    char ***values)
+{
+    int count = -1;
+    *values = NULL;
+
+    pthread_mutex_lock(&CACHE_LOCK);
+    CACHE_ENTRY *entry = findEntry(key);
+    if (entry && strcmp(entry->stamp, stamp) == 0)
+    {
+        count = entry->count;
+        if (count > 0)
+        {
+            *values = arenaAlloc(arena, count * sizeof(char *));
+            for (int i = 0; *values && i < count; i++)
+            {
+                (*values)[i] = arenaStrdup(arena, entry->values[i]);
+                if (!(*values)[i])
+                    *values = NULL;
+            }
+            if (!*values)
+                count = -1;
+        }
+    }
+    pthread_mutex_unlock(&CACHE_LOCK);
+
+    return count;
+}
+
+/**
+ * @return String containing the path of our cache directory (ending in '/');
+ *         NULL if there is nowhere suitable
+ */
+char *getCacheDir(void)
+{
+    char path[PATH_MAX];
+    const char *xdgCache = getenv("XDG_CACHE_HOME");
+
+    if (xdgCache && xdgCache[0] == '/')
+        snprintf(path, PATH_MAX, "%s/shorkutils/", xdgCache);
+    else if (HOME && HOME[0] != '\0')
+        snprintf(path, PATH_MAX, "%s/.cache/shorkutils/", HOME);
+    else
+        return NULL;
+
+    return strdup(path);
+}
+
+/**
+ * Creates our cache directory if it does not exist yet.
+ * @return String containing the path of our cache directory (ending in '/');
+ *         NULL if there is nowhere suitable
+ */
+char *makeCacheDir(void)
+{
+    char *dir = getCacheDir();
+    if (!dir) return NULL;
+
+    // This is broken into parts in case the system does not have .cache/
+    int len = strlen(dir);
+    dir[len - 1] = '\0';
+    char *parent = strrchr(dir, '/');
+    if (parent && parent != dir)
+    {
+        *parent = '\0';
+        mkdir(dir, 0755);
+        *parent = '/';
+    }
+    mkdir(dir, 0755);
+    dir[len - 1] = '/';
+
+    return dir;
+}
+
+/**
+ * Reads shorkfetch.cache, discarding it if it is from a different boot or
+ * output style.
+ */
+void readCache(void)
+{
+    freeCache();
+
+    // Values found under a sysroot are not this system's, so never cache
+    BOOT_ID[0] = '\0';
+    if (getSysroot()) return;
+
+    // Without a boot ID, we have no way to tell if cached values are stale
+    FILE *bootFile = fopen("/proc/sys/kernel/random/boot_id", "r");
+    if (!bootFile) return;
+    if (fgets(BOOT_ID, BOOT_ID_LEN, bootFile))
+        BOOT_ID[strcspn(BOOT_ID, "\n")] = '\0';
+    fclose(bootFile);
+    if (BOOT_ID[0] == '\0') return;
+
+    char *dir = getCacheDir();
+    if (!dir) return;
+    char path[PATH_MAX];
+    snprintf(path, PATH_MAX, "%sshorkfetch.cache", dir);
+    free(dir);
+
+    FILE *cache = fopen(path, "r");
+    if (!cache) return;
+
+    // The header must match this run exactly for anything to be used
+    char expected[CACHE_LINE_LEN];
+    snprintf(expected, CACHE_LINE_LEN, "format=%d\nboot=%s\ncompact=%d\n",
+        CACHE_FORMAT, BOOT_ID, COMPACT);
+    char header[CACHE_LINE_LEN] = "";
+    int headerLen = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        if (!fgets(header + headerLen, CACHE_LINE_LEN - headerLen, cache))
+            break;
+        headerLen = strlen(header);
+    }
+    if (strcmp(header, expected) != 0)
+    {
+        fclose(cache);
+        return;
+    }
+
+    // Entries are a "key=stamp" line followed by a line for each value,
+    // which are indented by a space
+    char line[CACHE_LINE_LEN];
+    CACHE_ENTRY *entry = NULL;
+    while (fgets(line, sizeof(line), cache))
+    {
+        line[strcspn(line, "\n")] = '\0';
+
+        if (line[0] == ' ')
+        {
+            if (entry) addValue(entry, line + 1);
+            continue;
+        }
+
+        char *eq = strchr(line, '=');
+        if (!eq)
+        {
+            entry = NULL;
+            continue;
+        }
+        *eq = '\0';
+        entry = addEntry(line, eq + 1);
+    }
+    fclose(cache);
+}
+
+/**
+ * Caches a value, replacing any existing value with the same name.
+ * @param key Name of the value
+ * @param stamp Summary of the value's sources as they are now
+ * @param values Value line(s) to cache copies of
+ * @param count Number of value lines (0 caches that there is no value)
+ */
+void setCached(const char *key, const char *stamp, char **values,
+    const int count)
+{
+    pthread_mutex_lock(&CACHE_LOCK);
+    if (BOOT_ID[0] != '\0')
+    {
+        CACHE_ENTRY *entry = findEntry(key);
+        if (entry)
+        {
+            freeEntry(entry);
+            entry->key = strdup(key);
+            entry->stamp = strdup(stamp);
+            entry->values = NULL;
+            entry->count = 0;
+        }
+        else
+            entry = addEntry(key, stamp);
+
+        if (entry)
+        {
+            for (int i = 0; i < count; i++)
+                addValue(entry, values[i] ? values[i] : "");
+            CACHE_DIRTY = 1;
+        }
+    }
+    pthread_mutex_unlock(&CACHE_LOCK);
+}
+
+/**
+ * Adds a summary of a directory's listing to a stamp, so that entries being
+ * added or removed changes it.
+ * @param stamp Stamp to append to
+ * @param size Stamp's buffer size
+ * @param path Path to directory
+ */
+void stampDirList(char *stamp, const int size, const char *path)
+{
+    int len = strlen(stamp);
+    DIR *dir = opendir(path);
+    if (!dir)
+    {
+        snprintf(stamp + len, size - len, "-;");
+        return;
+    }
+
+    // FNV-1a hash of every entry's name
+    unsigned int hash = 2166136261u;
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        for (const char *c = entry->d_name; *c; c++)
+            hash = (hash ^ (unsigned char)*c) * 16777619u;
+        hash = (hash ^ '/') * 16777619u;
+        count++;
+    }
+    closedir(dir);
+
+    snprintf(stamp + len, size - len, "%d:%08x;", count, hash);
+}
+
+/**
+ * Adds a summary of a file's modification time and size to a stamp.
+ * @param stamp Stamp to append to
+ * @param size Stamp's buffer size
+ * @param path Path to file or directory
+ */
+void stampFile(char *stamp, const int size, const char *path)
+{
+    int len = strlen(stamp);
+    struct stat st;
+    if (stat(path, &st) != 0)
+        snprintf(stamp + len, size - len, "-;");
+    else
+        snprintf(stamp + len, size - len, "%lld.%ld:%lld;",
+            (long long)st.st_mtim.tv_sec, (long)st.st_mtim.tv_nsec,
+            (long long)st.st_size);
+}
+
+/**
+ * Writes shorkfetch.cache if anything has changed since it was read.
+ */
+void writeCache(void)
+{
+    if (!CACHE_DIRTY || BOOT_ID[0] == '\0') return;
+
+    char *dir = makeCacheDir();
+    if (!dir) return;
+
+    // Write to a temporary file first, so a concurrent run never sees a
+    // half-written cache
+    char tmpPath[PATH_MAX + 32];
+    char finalPath[PATH_MAX + 16];
+    snprintf(tmpPath, sizeof(tmpPath), "%sshorkfetch.cache.%d", dir,
+        (int)getpid());
+    snprintf(finalPath, sizeof(finalPath), "%sshorkfetch.cache", dir);
+    free(dir);
+
+    FILE *cache = fopen(tmpPath, "w");
+    if (!cache) return;
+
+    fprintf(cache, "format=%d\nboot=%s\ncompact=%d\n", CACHE_FORMAT, BOOT_ID,
+        COMPACT);
+    for (int i = 0; i < ENTRIES_LEN; i++)
+    {
+        fprintf(cache, "%s=%s\n", ENTRIES[i].key, ENTRIES[i].stamp);
+        // Values are single lines, so anything past a newline is dropped
+        for (int j = 0; j < ENTRIES[i].count; j++)
+            fprintf(cache, " %.*s\n",
+                (int)strcspn(ENTRIES[i].values[j], "\n"), ENTRIES[i].values[j]);
+    }
+
+    if (fclose(cache) == 0)
+        rename(tmpPath, finalPath);
+    else
+        remove(tmpPath);
+    CACHE_DIRTY = 0;
+}
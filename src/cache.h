@@ -0,0 +1,53 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to caching slow to   ##
+    ## find values between runs in the same boot        ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#ifndef CACHE
+#define CACHE
+
+#include "arena.h"
+
+
+
+typedef struct {
+    // Name of the cached value (e.g., "gpu")
+    char *key;
+    // Summary of the sources the value was found from when it was cached
+    char *stamp;
+    // Cached value's line(s)
+    char **values;
+    int count;
+} CACHE_ENTRY;
+
+
+
+#define BOOT_ID_LEN         64
+// Bump if the cache file format or the meaning of any cached value changes
+#define CACHE_FORMAT        3
+#define CACHE_LINE_LEN      1024
+#define CACHE_STAMP_LEN     512
+
+
+
+void freeCache(void);
+int getCached(MEM_ARENA *, const char *, const char *, char ***);
+char *getCacheDir(void);
+char *makeCacheDir(void);
+void readCache(void);
+void setCached(const char *, const char *, char **, const int);
+void stampDirList(char *, const int, const char *);
+void stampFile(char *, const int, const char *);
+void writeCache(void);
+
+#endif
@@ -0,0 +1,736 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to collecting the    ##
+    ## requested fields' values ahead of rendering      ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#include "arena.h"
+#include "cache.h"
+#include "collect.h"
+#include "de-wm.h"
+#include "disk.h"
+#include "globals.h"
+#include "gpu.h"
+#include "ip.h"
+#include "kernel.h"
+#include "os.h"
+#include "packages.h"
+#include "screen.h"
+#include "shell.h"
+#include "terminal.h"
+#include "uptime.h"
+
+#include <linux/limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+
+typedef struct {
+    COLLECTION *collection;
+    FIELD_ID jobs[FIELDS_LEN];
+    int noJobs;
+    int next;
+    pthread_mutex_t lock;
+} JOB_QUEUE;
+
+
+
+// Guard looking up data that more than one collector may need
+static pthread_mutex_t CPU_DATA_LOCK = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t DE_WM_LOCK = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t MEM_INFO_LOCK = PTHREAD_MUTEX_INITIALIZER;
+// Guards every field's state, and signals when a field is done
+static pthread_mutex_t FIELDS_LOCK = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t FIELDS_DONE = PTHREAD_COND_INITIALIZER;
+
+
+
+/**
+ * Adds the state of every file in a sources list to a cache stamp.
+ * @param stamp Stamp to append to
+ * @param sources List of source paths
+ * @param len Number of source paths
+ */
+static void stampSources(char *stamp, const char **sources, const int len)
+{
+    for (int i = 0; i < len; i++)
+    {
+        if (strncmp(sources[i], "~/", 2) == 0)
+        {
+            char path[PATH_MAX];
+            snprintf(path, PATH_MAX, "%s/%s", HOME ? HOME : "", sources[i] + 2);
+            stampFile(stamp, CACHE_STAMP_LEN, path);
+        }
+        else
+            stampFile(stamp, CACHE_STAMP_LEN, sources[i]);
+    }
+}
+
+/**
+ * Appends a line to a field's value. The lines array is grown in the arena by
+ * doubling, as the old array cannot be given back to it.
+ * @param arena Arena the value is allocated from
+ * @param value Value to add to
+ * @param line Line to add, which must live as long as the arena; NULL adds
+ *             nothing
+ */
+static void addLine(MEM_ARENA *arena, FIELD_VALUE *value, char *line)
+{
+    if (!line) return;
+
+    if (value->count == value->capacity)
+    {
+        int capacity = value->capacity > 0 ? value->capacity * 2 : 4;
+        char **grown = arenaAlloc(arena, capacity * sizeof(char *));
+        if (!grown) return;
+        if (value->count > 0)
+            memcpy(grown, value->lines, value->count * sizeof(char *));
+        value->lines = grown;
+        value->capacity = capacity;
+    }
+    value->lines[value->count++] = line;
+}
+
+/**
+ * @param c Collection to look in
+ * @param id Field to get the value of
+ * @return A field's first value line; NULL if it has none
+ */
+static const char *firstLine(const COLLECTION *c, const FIELD_ID id)
+{
+    return c->values[id].count > 0 ? c->values[id].lines[0] : NULL;
+}
+
+/**
+ * Looks up the CPU's data the first time it is needed. It is also the source
+ * of the fallback GPU name for SoCs.
+ * @param c Collection to store the CPU's data in
+ * @return The CPU's data; NULL if it could not be found
+ */
+static CPU_DATA *needCPUData(COLLECTION *c)
+{
+    pthread_mutex_lock(&CPU_DATA_LOCK);
+    if (!c->cpuLookedUp)
+    {
+        c->cpu = getCPU("/proc/cpuinfo", &c->gpuFromCPU);
+        c->cpuLookedUp = 1;
+    }
+    pthread_mutex_unlock(&CPU_DATA_LOCK);
+    return c->cpu;
+}
+
+/**
+ * Looks up the DE and WM the first time either is needed. They are found
+ * together, as the WM lookup may find that the DE is really a WM.
+ * @param c Collection to store the DE and WM in
+ */
+static void needDEWM(COLLECTION *c)
+{
+    pthread_mutex_lock(&DE_WM_LOCK);
+    if (!c->deWMLookedUp)
+    {
+        c->de = getDE(c->arena);
+        c->wm = getWM(c->arena, &c->de);
+        c->deWMLookedUp = 1;
+    }
+    pthread_mutex_unlock(&DE_WM_LOCK);
+}
+
+/**
+ * Reads /proc/meminfo the first time it is needed.
+ * @param c Collection to store the memory information in
+ * @return The memory information
+ */
+static MemInfo needMemInfo(COLLECTION *c)
+{
+    pthread_mutex_lock(&MEM_INFO_LOCK);
+    if (!c->memLookedUp)
+    {
+        c->mi = getMemInfo();
+        c->memLookedUp = 1;
+    }
+    pthread_mutex_unlock(&MEM_INFO_LOCK);
+    return c->mi;
+}
+
+
+
+static void collectOS(COLLECTION *c, FIELD_VALUE *v)
+{
+    addLine(c->arena, v, getOS(c->arena, c->u, c->uStatus));
+}
+
+static void collectKernel(COLLECTION *c, FIELD_VALUE *v)
+{
+    addLine(c->arena, v, getKernel(c->arena, c->u, c->uStatus));
+}
+
+static void collectUptime(COLLECTION *c, FIELD_VALUE *v)
+{
+    addLine(c->arena, v, getUptime(c->arena));
+}
+
+static void collectPackages(COLLECTION *c, FIELD_VALUE *v)
+{
+    addLine(c->arena, v, getPackages(c->arena, firstLine(c, FIELD_OS)));
+}
+
+static void collectScreens(COLLECTION *c, FIELD_VALUE *v)
+{
+    int noScreens = 0;
+    Screen *screens = getScreens(&noScreens);
+    if (!screens) return;
+
+    // Keep every screen's line, even empty ones, so the label still reflects
+    // how many there are
+    for (int i = 0; i < noScreens; i++)
+    {
+        char *screen = interpretScreen(c->arena, &screens[i]);
+        addLine(c->arena, v, screen ? screen : arenaStrdup(c->arena, ""));
+    }
+    free(screens);
+}
+
+static void collectDE(COLLECTION *c, FIELD_VALUE *v)
+{
+    needDEWM(c);
+
+    // If the DE is the WM, it is only shown as the WM
+    if (c->de && c->de != c->wm)
+        addLine(c->arena, v, c->de);
+}
+
+static void collectWM(COLLECTION *c, FIELD_VALUE *v)
+{
+    needDEWM(c);
+    if (!c->wm || c->wm[0] == '\0') return;
+
+    char server[32] = "";
+    if (!COMPACT)
+    {
+        if (WAYLAND_PRESENT)
+            snprintf(server, 32, " (Wayland)");
+        else if (X11_PRESENT)
+            snprintf(server, 32, " (X11)");
+    }
+
+    char wm[256];
+    snprintf(wm, 256, "%s%s", c->wm, server);
+    addLine(c->arena, v, arenaStrdup(c->arena, wm));
+}
+
+static void collectTerminal(COLLECTION *c, FIELD_VALUE *v)
+{
+    char value[256];
+    char *trm = getTerminal(c->arena);
+    if (trm && trm[0] != '\0')
+    {
+        if (!COMPACT)
+            snprintf(value, 256, "%s (%dx%d)", trm, TERM_SIZE.ws_col,
+                TERM_SIZE.ws_row);
+        else
+            snprintf(value, 256, "%s", trm);
+    }
+    // If we don't have a terminal name, we can at least still show the
+    // console size
+    else
+    {
+        snprintf(value, 256, "%dx%d", TERM_SIZE.ws_col, TERM_SIZE.ws_row);
+        v->renderAs = FIELD_CON;
+    }
+    addLine(c->arena, v, arenaStrdup(c->arena, value));
+}
+
+static void collectShell(COLLECTION *c, FIELD_VALUE *v)
+{
+    addLine(c->arena, v, getShell(c->arena));
+}
+
+static void collectCPU(COLLECTION *c, FIELD_VALUE *v)
+{
+    CPU_DATA *cpu = needCPUData(c);
+    if (cpu)
+        addLine(c->arena, v, arenaTake(c->arena, interpretCPU(cpu)));
+}
+
+static void collectISA(COLLECTION *c, FIELD_VALUE *v)
+{
+    CPU_DATA *cpu = needCPUData(c);
+    if (cpu)
+        addLine(c->arena, v, arenaTake(c->arena, interpretISA(cpu)));
+}
+
+static void collectGPUs(COLLECTION *c, FIELD_VALUE *v)
+{
+    int noGPUs = 0;
+    GPU_IDS *gpus = getGPUs(&noGPUs);
+    // Identical GPUs share a line, e.g. "8x NVIDIA H100"
+    int *counts = gpus ? groupGPUs(gpus, &noGPUs) : NULL;
+    if (counts && noGPUs > 0)
+    {
+        char **names = interpretGPUs(gpus, noGPUs, firstLine(c, FIELD_OS));
+        for (int i = 0; names && i < noGPUs; i++)
+        {
+            char *name = NULL;
+            if (counts[i] > 1)
+            {
+                int nameSize = strlen(names[i]) + 16;
+                name = arenaAlloc(c->arena, nameSize);
+                if (name)
+                    snprintf(name, nameSize, "%dx %s", counts[i], names[i]);
+                free(names[i]);
+            }
+            else
+                name = arenaTake(c->arena, names[i]);
+            addLine(c->arena, v, name);
+        }
+        free(names);
+    }
+    free(counts);
+    free(gpus);
+
+    // If we found no GPUs the "traditional" way, at least check if we
+    // received a fallback found during CPU name processing
+    if (v->count == 0)
+    {
+        needCPUData(c);
+        if (c->gpuFromCPU)
+            addLine(c->arena, v, arenaStrdup(c->arena, c->gpuFromCPU));
+    }
+}
+
+static void collectRAM(COLLECTION *c, FIELD_VALUE *v)
+{
+    MemInfo mi = needMemInfo(c);
+    if (mi.memTotal > 0)
+        addLine(c->arena, v, getRAM(c->arena, mi));
+}
+
+static void collectSwap(COLLECTION *c, FIELD_VALUE *v)
+{
+    MemInfo mi = needMemInfo(c);
+    if (mi.swapTotal > 0)
+        addLine(c->arena, v, getSwap(c->arena, mi));
+}
+
+static void collectDisks(COLLECTION *c, FIELD_VALUE *v)
+{
+    DISKS *disks = getDisks(c->arena);
+    if (!disks) return;
+
+    for (int i = 0; i < disks->count && i < DISKS_LEN; i++)
+        addLine(c->arena, v, disks->disks[i]);
+}
+
+static void collectRoot(COLLECTION *c, FIELD_VALUE *v)
+{
+    addLine(c->arena, v, getRoot(c->arena));
+}
+
+static void collectLocalIP(COLLECTION *c, FIELD_VALUE *v)
+{
+    if (!c->noIP)
+        addLine(c->arena, v, getLocalIP(c->arena));
+}
+
+
+
+static void stampOS(char *stamp)
+{
+    stampSources(stamp, OS_SOURCES, OS_SOURCES_LEN);
+}
+
+static void stampPackages(char *stamp)
+{
+    stampSources(stamp, PKGS_SOURCES, PKGS_SOURCES_LEN);
+}
+
+static void stampGPUs(char *stamp)
+{
+    // GPUs can only change if a PCI device comes or goes
+    stampSources(stamp, GPU_SOURCES, GPU_SOURCES_LEN);
+    stampDirList(stamp, CACHE_STAMP_LEN, "/sys/bus/pci/devices");
+}
+
+static void stampDisks(char *stamp)
+{
+    // Disks can only change if a block device comes or goes
+    stampDirList(stamp, CACHE_STAMP_LEN, "/sys/block");
+}
+
+
+
+const FIELD_DESC FIELDS[FIELDS_LEN] = {
+    [FIELD_BLANK] = { FIELD_BLANK, " ", NULL, NULL, NULL, NULL, NULL,
+        NULL, NULL, 0, FIELD_LAYOUT },
+    [FIELD_SEPARATOR] = { FIELD_SEPARATOR, "---", NULL, NULL, NULL, NULL,
+        NULL, NULL, NULL, 0, FIELD_LAYOUT },
+    [FIELD_OS] = { FIELD_OS, "os", "OS", NULL, "OS", "", "",
+        collectOS, stampOS, 0, FIELD_CACHED },
+    [FIELD_KRN] = { FIELD_KRN, "krn", "Kernel", NULL, "Krn", "", "",
+        collectKernel, NULL, 0, FIELD_LIVE },
+    [FIELD_UPT] = { FIELD_UPT, "upt", "Uptime", NULL, "Up", "", "",
+        collectUptime, NULL, 0, FIELD_LIVE },
+    [FIELD_PKGS] = { FIELD_PKGS, "pkgs", "Packages", NULL, "Pkg", "", "",
+        collectPackages, stampPackages, FIELD_BIT(FIELD_OS), FIELD_CACHED },
+    [FIELD_SCN] = { FIELD_SCN, "scn", "Screen", "Screens", "Scn", "", "",
+        collectScreens, NULL, 0, FIELD_LIVE },
+    [FIELD_DE] = { FIELD_DE, "de", "DE", NULL, "DE", "", "",
+        collectDE, NULL, 0, FIELD_LIVE },
+    [FIELD_WM] = { FIELD_WM, "wm", "WM", NULL, "WM", "", "",
+        collectWM, NULL, 0, FIELD_LIVE },
+    [FIELD_TRM] = { FIELD_TRM, "trm", "Terminal", NULL, "Trm", "", "",
+        collectTerminal, NULL, 0, FIELD_LIVE },
+    [FIELD_SH] = { FIELD_SH, "sh", "Shell", NULL, "Sh", "", "",
+        collectShell, NULL, 0, FIELD_LIVE },
+    [FIELD_CPU] = { FIELD_CPU, "cpu", "CPU", NULL, "CPU", "", "",
+        collectCPU, NULL, 0, FIELD_CACHED },
+    [FIELD_ISA] = { FIELD_ISA, "isa", "ISA", NULL, "ISA", "", "",
+        collectISA, NULL, 0, FIELD_CACHED },
+    [FIELD_GPU] = { FIELD_GPU, "gpu", "GPU", "GPUs", "GPU", "", "",
+        collectGPUs, stampGPUs, FIELD_BIT(FIELD_OS), FIELD_CACHED },
+    [FIELD_RAM] = { FIELD_RAM, "ram", "RAM", NULL, "RAM", " RAM", " (R)",
+        collectRAM, NULL, 0, FIELD_LIVE },
+    [FIELD_SWAP] = { FIELD_SWAP, "swap", "Swap", NULL, "Swp", " swap",
+        " (S)", collectSwap, NULL, 0, FIELD_LIVE },
+    [FIELD_DSK] = { FIELD_DSK, "dsk", "Disk", "Disks", "Dsk", " disk", "",
+        collectDisks, stampDisks, 0, FIELD_CACHED },
+    [FIELD_ROOT] = { FIELD_ROOT, "root", "Root", NULL, "/", " root", " (/)",
+        collectRoot, NULL, 0, FIELD_LIVE },
+    [FIELD_LIP] = { FIELD_LIP, "lip", "Local IP", NULL, "Loc", " local",
+        " (L)", collectLocalIP, NULL, 0, FIELD_LIVE },
+    [FIELD_CLRS] = { FIELD_CLRS, "clrs", NULL, NULL, NULL, NULL, NULL,
+        NULL, NULL, 0, FIELD_LAYOUT },
+    [FIELD_CLBA] = { FIELD_CLBA, "clba", NULL, NULL, NULL, NULL, NULL,
+        NULL, NULL, 0, FIELD_LAYOUT },
+    [FIELD_CLBR] = { FIELD_CLBR, "clbr", NULL, NULL, NULL, NULL, NULL,
+        NULL, NULL, 0, FIELD_LAYOUT },
+    [FIELD_CON] = { FIELD_CON, NULL, "Console", NULL, "Con", " console",
+        "ch", NULL, NULL, 0, FIELD_LAYOUT }
+};
+
+// Slowest (subprocess or database scanning) collectors come first so they
+// start as soon as possible
+static const FIELD_ID COLLECT_ORDER[] = {
+    FIELD_PKGS,
+    FIELD_OS,
+    FIELD_SCN,
+    FIELD_GPU,
+    FIELD_DSK,
+    FIELD_TRM,
+    FIELD_CPU,
+    FIELD_ISA,
+    FIELD_KRN,
+    FIELD_UPT,
+    FIELD_DE,
+    FIELD_WM,
+    FIELD_SH,
+    FIELD_RAM,
+    FIELD_SWAP,
+    FIELD_ROOT,
+    FIELD_LIP
+};
+static const int COLLECT_ORDER_LEN = sizeof(COLLECT_ORDER) /
+    sizeof(COLLECT_ORDER[0]);
+
+
+
+static void requireField(COLLECTION *, const FIELD_ID);
+
+/**
+ * Runs a field's collector, after making sure the fields it depends on have
+ * been collected.
+ * @param c Collection to store the value in
+ * @param id Field to collect
+ * @param start Snapshot the field's timing started from, which is moved on
+ *              past any dependencies so they are not counted twice
+ */
+static void runCollector(COLLECTION *c, const FIELD_ID id, IO_STATS *start)
+{
+    const FIELD_DESC *desc = &FIELDS[id];
+    FIELD_VALUE *value = &c->values[id];
+
+    if (desc->deps)
+    {
+        if (c->timings) addIOStats(&value->stats, start);
+        for (int dep = 0; dep < FIELDS_LEN; dep++)
+            if (desc->deps & FIELD_BIT(dep))
+                requireField(c, dep);
+        if (c->timings) *start = getIOStats();
+    }
+
+    desc->collect(c, value);
+}
+
+/**
+ * Collects a single field's value, using the cache where its volatility
+ * allows. Dependencies are only collected if the cache cannot be used.
+ * @param c Collection to store the value in
+ * @param id Field to collect
+ */
+static void collectField(COLLECTION *c, const FIELD_ID id)
+{
+    const FIELD_DESC *desc = &FIELDS[id];
+    FIELD_VALUE *value = &c->values[id];
+    if (!desc->collect) return;
+
+    IO_STATS start;
+    if (c->timings) start = getIOStats();
+
+    if (desc->volatility != FIELD_CACHED)
+        runCollector(c, id, &start);
+    else
+    {
+        // Values that only depend on the boot have an empty stamp
+        char stamp[CACHE_STAMP_LEN] = "";
+        if (desc->stamp)
+            desc->stamp(stamp);
+
+        int count = getCached(c->arena, desc->name, stamp, &value->lines);
+        if (count != -1)
+        {
+            value->count = count;
+            value->capacity = count;
+            value->fromCache = 1;
+        }
+        else
+        {
+            runCollector(c, id, &start);
+            setCached(desc->name, stamp, value->lines, value->count);
+        }
+    }
+
+    if (c->timings) addIOStats(&value->stats, &start);
+}
+
+/**
+ * Collects a field's value if it has not been already. If another thread is
+ * collecting it, this waits for that to finish instead.
+ * @param c Collection to store the value in
+ * @param id Field to collect
+ */
+static void requireField(COLLECTION *c, const FIELD_ID id)
+{
+    FIELD_VALUE *value = &c->values[id];
+
+    pthread_mutex_lock(&FIELDS_LOCK);
+    while (value->state == FIELD_RUNNING)
+        pthread_cond_wait(&FIELDS_DONE, &FIELDS_LOCK);
+    if (value->state == FIELD_DONE)
+    {
+        pthread_mutex_unlock(&FIELDS_LOCK);
+        return;
+    }
+    value->state = FIELD_RUNNING;
+    pthread_mutex_unlock(&FIELDS_LOCK);
+
+    collectField(c, id);
+
+    pthread_mutex_lock(&FIELDS_LOCK);
+    value->state = FIELD_DONE;
+    pthread_cond_broadcast(&FIELDS_DONE);
+    pthread_mutex_unlock(&FIELDS_LOCK);
+}
+
+/**
+ * Runs queued collectors until the queue is empty. Used as the body of each
+ * worker thread, as well as by the main thread alongside them.
+ * @param arg The JOB_QUEUE to take collectors from
+ */
+static void *collectWorker(void *arg)
+{
+    JOB_QUEUE *queue = (JOB_QUEUE *)arg;
+
+    while (1)
+    {
+        pthread_mutex_lock(&queue->lock);
+        int job = -1;
+        if (queue->next < queue->noJobs)
+            job = queue->jobs[queue->next++];
+        pthread_mutex_unlock(&queue->lock);
+
+        if (job == -1) break;
+        requireField(queue->collection, job);
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * Collects the values of every requested field. Each distinct field is
+ * collected once, spread over a small pool of worker threads so the time
+ * taken is that of the slowest collector rather than the sum of them all.
+ * Nothing else is collected unless a requested field's collector needs it.
+ * Single-CPU systems run the collectors serially instead. Slow to find values
+ * that cannot have changed since the last run are taken from the cache
+ * instead.
+ * @param collection Collection with its inputs filled in and values zeroed
+ * @param fields Requested fields
+ * @param noFields Number of requested fields
+ */
+void collectFields(COLLECTION *collection, const FIELD_ID *fields,
+    const int noFields)
+{
+    for (int i = 0; i < FIELDS_LEN; i++)
+    {
+        collection->values[i].renderAs = i;
+        collection->values[i].state = FIELD_PENDING;
+    }
+
+    IO_STATS start;
+    if (collection->timings) start = getIOStats();
+
+    readCache();
+
+    JOB_QUEUE queue;
+    queue.collection = collection;
+    queue.noJobs = 0;
+    queue.next = 0;
+
+    // Queue each needed field once, even if it is repeated
+    for (int i = 0; i < COLLECT_ORDER_LEN; i++)
+    {
+        for (int j = 0; j < noFields; j++)
+        {
+            if (fields[j] == COLLECT_ORDER[i])
+            {
+                queue.jobs[queue.noJobs++] = COLLECT_ORDER[i];
+                break;
+            }
+        }
+    }
+
+    int workers = queue.noJobs < COLLECT_MAX_WORKERS ? queue.noJobs :
+        COLLECT_MAX_WORKERS;
+    if (workers < 1 || sysconf(_SC_NPROCESSORS_ONLN) <= 1)
+        workers = 1;
+
+    pthread_mutex_init(&queue.lock, NULL);
+
+    // The main thread is a worker too, so only start the others
+    pthread_t threads[COLLECT_MAX_WORKERS];
+    int started = 0;
+    for (int i = 1; i < workers; i++)
+    {
+        if (pthread_create(&threads[started], NULL, collectWorker,
+            &queue) != 0)
+            break;
+        started++;
+    }
+
+    collectWorker(&queue);
+
+    for (int i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+
+    pthread_mutex_destroy(&queue.lock);
+
+    writeCache();
+    freeCache();
+
+    if (collection->timings) addIOStats(&collection->stats, &start);
+}
+
+/**
+ * @param name Field name as given in a fields list
+ * @return The named field's ID; -1 if there is no such field
+ */
+int findField(const char *name)
+{
+    for (int i = 0; i < FIELDS_LEN; i++)
+        if (FIELDS[i].name && strcmp(FIELDS[i].name, name) == 0)
+            return i;
+    return -1;
+}
+
+/**
+ * Frees what a collection holds outside of its arena, which is only the
+ * CPU's data. Everything else goes when the arena is freed.
+ * @param collection Collection to free
+ */
+void freeCollection(COLLECTION *collection)
+{
+    free(collection->gpuFromCPU);
+    freeCPU(collection->cpu);
+}
+
+/**
+ * Prints the time taken and I/O done by each collected field, rendering and
+ * the run as a whole to stderr. The total's time is wall-clock time, so with
+ * worker threads it is less than the sum of the fields' times.
+ * @param collection Collection that was collected with timings on
+ * @param render Time taken and I/O done to render the output
+ * @param csv Flags if the report should be CSV instead of a table
+ */
+void printTimings(const COLLECTION *collection, const IO_STATS *render,
+    const int csv)
+{
+    IO_STATS total = { collection->stats.usecs + render->usecs, 0, 0, 0 };
+
+    if (csv)
+        fprintf(stderr, "field,source,usecs,files,bytes,subprocesses\n");
+    else
+        fprintf(stderr, "%-8s %-6s %10s %6s %10s %6s\n", "Field", "Source",
+            "Time (us)", "Files", "Bytes", "Procs");
+
+    // Every collected field, then rendering, then the total
+    for (int i = 0; i <= FIELDS_LEN + 1; i++)
+    {
+        const char *name = "render";
+        const char *source = "-";
+        const IO_STATS *stats = render;
+        if (i < FIELDS_LEN)
+        {
+            if (collection->values[i].state != FIELD_DONE ||
+                !FIELDS[i].collect)
+                continue;
+            name = FIELDS[i].name;
+            source = collection->values[i].fromCache ? "cache" : "live";
+            stats = &collection->values[i].stats;
+        }
+        else if (i == FIELDS_LEN + 1)
+        {
+            name = "total";
+            stats = &total;
+        }
+
+        if (stats != &total)
+        {
+            total.filesOpened += stats->filesOpened;
+            total.subprocesses += stats->subprocesses;
+            if (stats->bytesRead == -1 || total.bytesRead == -1)
+                total.bytesRead = -1;
+            else
+                total.bytesRead += stats->bytesRead;
+        }
+
+        // Unknown byte counts are left empty in CSV
+        char bytes[32] = "";
+        if (stats->bytesRead != -1)
+            snprintf(bytes, 32, "%lld", stats->bytesRead);
+        else if (!csv)
+            snprintf(bytes, 32, "-");
+
+        if (csv)
+            fprintf(stderr, "%s,%s,%lld,%d,%s,%d\n", name, source,
+                stats->usecs, stats->filesOpened, bytes, stats->subprocesses);
+        else
+            fprintf(stderr, "%-8s %-6s %10lld %6d %10s %6d\n", name, source,
+                stats->usecs, stats->filesOpened, bytes, stats->subprocesses);
+    }
+}
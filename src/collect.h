@@ -0,0 +1,193 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to collecting the    ##
+    ## requested fields' values ahead of rendering      ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#ifndef COLLECT
+#define COLLECT
+
+#include "arena.h"
+#include "cpu.h"
+#include "io.h"
+#include "memory.h"
+
+#include <sys/utsname.h>
+
+
+
+typedef enum {
+    FIELD_BLANK,
+    FIELD_SEPARATOR,
+    FIELD_OS,
+    FIELD_KRN,
+    FIELD_UPT,
+    FIELD_PKGS,
+    FIELD_SCN,
+    FIELD_DE,
+    FIELD_WM,
+    FIELD_TRM,
+    FIELD_SH,
+    FIELD_CPU,
+    FIELD_ISA,
+    FIELD_GPU,
+    FIELD_RAM,
+    FIELD_SWAP,
+    FIELD_DSK,
+    FIELD_ROOT,
+    FIELD_LIP,
+    FIELD_CLRS,
+    FIELD_CLBA,
+    FIELD_CLBR,
+    // Not selectable; used to display trm when only the console size is known
+    FIELD_CON,
+    FIELDS_LEN
+} FIELD_ID;
+
+typedef enum {
+    // Layout only; there is nothing to collect
+    FIELD_LAYOUT,
+    // Always collected live
+    FIELD_LIVE,
+    // Cached until the boot or the value's sources change
+    FIELD_CACHED
+} VOLATILITY;
+
+typedef enum {
+    FIELD_PENDING,
+    FIELD_RUNNING,
+    FIELD_DONE
+} FIELD_STATE;
+
+typedef struct {
+    // Value line(s) in display order; NULL if nothing was found
+    char **lines;
+    int count;
+    // Number of lines there is room for before lines has to grow
+    int capacity;
+    // Which field's labels to display the value with (normally its own)
+    FIELD_ID renderAs;
+    // How far along collecting the value is
+    FIELD_STATE state;
+    // Flags if the value was taken from the cache
+    int fromCache;
+    // Time taken and I/O done to collect the value (only if timings are on)
+    IO_STATS stats;
+} FIELD_VALUE;
+
+typedef struct {
+    // Inputs to collection
+    // Arena every value (and anything found on demand other than the CPU's
+    // data) is allocated from
+    MEM_ARENA *arena;
+    struct utsname u;
+    int uStatus;
+    int noIP;
+    // Flags if the time taken and I/O done by each collector should be kept
+    int timings;
+
+    // Found on demand, as more than one field needs them
+    CPU_DATA *cpu;
+    char *gpuFromCPU;
+    int cpuLookedUp;
+    char *de;
+    char *wm;
+    int deWMLookedUp;
+    MemInfo mi;
+    int memLookedUp;
+
+    // Each field's collected value
+    FIELD_VALUE values[FIELDS_LEN];
+    // Time taken to collect every value (only if timings are on)
+    IO_STATS stats;
+} COLLECTION;
+
+typedef struct {
+    FIELD_ID id;
+    // Name used in fields lists (NULL if not selectable)
+    const char *name;
+    // Labels for normal mode, normal mode with multiple lines (NULL if the
+    // same) and compact mode (NULL if the field is layout only)
+    const char *label;
+    const char *pluralLabel;
+    const char *compactLabel;
+    // Text after the value in bullet mode, and in compact bullet mode
+    const char *bulletSuffix;
+    const char *compactBulletSuffix;
+    // Collects the field's value (NULL if layout only)
+    void (*collect)(COLLECTION *, FIELD_VALUE *);
+    // Adds the state of the value's sources to a cache stamp (NULL if it only
+    // depends on the boot)
+    void (*stamp)(char *);
+    // Bitmask (FIELD_BIT) of fields whose values this field's collector uses;
+    // they are only collected if the collector actually has to run
+    unsigned int deps;
+    VOLATILITY volatility;
+} FIELD_DESC;
+
+
+
+#define FIELD_BIT(id)               (1u << (id))
+// Label widths (including padding) in normal and compact modes
+#define FIELD_LABEL_WIDTH           10
+#define FIELD_COMPACT_LABEL_WIDTH   5
+
+
+
+extern const FIELD_DESC FIELDS[FIELDS_LEN];
+
+// Files whose state decides if cached values are still valid ("~/" means in
+// the user's home directory)
+static const char *OS_SOURCES[] = {
+    "/etc/os-release",
+    "/etc/issue"
+};
+static const int OS_SOURCES_LEN = sizeof(OS_SOURCES) / sizeof(OS_SOURCES[0]);
+
+static const char *PKGS_SOURCES[] = {
+    "/var/lib/dpkg/status",
+    "/var/lib/pacman/local",
+    "/var/lib/rpm",
+    "/usr/lib/sysimage/rpm",
+    "/var/lib/flatpak/app",
+    "/var/lib/flatpak/runtime",
+    "~/.local/share/flatpak/app",
+    "~/.local/share/flatpak/runtime",
+    "/snap",
+    "/var/lib/snapd/snap"
+};
+static const int PKGS_SOURCES_LEN = sizeof(PKGS_SOURCES) /
+    sizeof(PKGS_SOURCES[0]);
+
+static const char *GPU_SOURCES[] = {
+    "/usr/share/misc/pci.ids",
+    "/usr/share/hwdata/pci.ids",
+    "/usr/share/libdrm/amdgpu.ids",
+    "~/.local/share/libdrm/amdgpu.ids"
+};
+static const int GPU_SOURCES_LEN = sizeof(GPU_SOURCES) /
+    sizeof(GPU_SOURCES[0]);
+
+
+
+// Most that will run at once; collectors are mostly I/O- or subprocess-bound,
+// so this is more about not over-subscribing small machines than CPU count
+#define COLLECT_MAX_WORKERS 4
+
+
+
+void collectFields(COLLECTION *, const FIELD_ID *, const int);
+int findField(const char *);
+void freeCollection(COLLECTION *);
+void printTimings(const COLLECTION *, const IO_STATS *, const int);
+
+#endif
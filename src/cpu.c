@@ -21,19 +21,30 @@
 
 
 #include "cpu.h"
+#include "cpuid.h"
+#include "cpurules.h"
 #include "general.h"
 #include "globals.h"
 #include "gpu.h"
+#include "io.h"
 #ifndef NO_STR_CLEANING
 #include "replacements.h"
+#include "replacer.h"
 #endif
 
 #include <ctype.h>
+#include <fcntl.h>
+#include <linux/limits.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 
 
+#ifdef TESTS
+int CPU_RULE_HITS[sizeof(CPU_RULES) / sizeof(CPU_RULES[0])];
+#endif
+
 #ifndef X86_ONLY
 
 // Hardcoded ARM CPU implementer values to allow basic ARM CPU vendor
@@ -106,22 +117,10 @@ char *cleanCPUName(const CPU_ARCH arch, const char *input, int inputSize)
 
     // Shorten " / " to "/"
     if (strstr(result, " / "))
-    {
-        char *tmp = findReplace(result, inputSize, " / ", "/");
-        strncpy(result, tmp, inputSize - 1);
-        result[inputSize - 1] = '\0';
-        free(tmp);
-    }
+        findReplaceIn(result, inputSize, " / ", "/");
 
     // Apply generic deletions
-    for (int i = 0; i < DELETIONS_LEN; i++)
-    {
-        const char *pattern = DELETIONS[i];
-        char *tmp = findErase(result, inputSize, pattern);
-        strncpy(result, tmp, inputSize - 1);
-        result[inputSize - 1] = '\0';
-        free(tmp);
-    }
+    replaceAll(getReplacer(REPLACER_DELETIONS), result, result, inputSize);
 
     // Remove clock speed from CPU name
     char *hz = strstr(result, "Hz");
@@ -158,85 +157,39 @@ char *cleanCPUName(const CPU_ARCH arch, const char *input, int inputSize)
     {
         // Shorten "Advanced Micro Devices" to "AMD"
         if (strstr(result, "Advanced Micro Devices"))
-        {
-            char *tmp = findReplace(result, inputSize,
-                "Advanced Micro Devices", "AMD");
-            strncpy(result, tmp, inputSize - 1);
-            result[inputSize - 1] = '\0';
-            free(tmp);
-        }
+            findReplaceIn(result, inputSize, "Advanced Micro Devices", "AMD");
 
         // Apply AMD-specific replacements
         if (strstr(result, "AMD"))
         {
-            int replaces = 0;
-            for (int i = 0; i < AMD_REPLACES_LEN; i++)
-            {
-                if (AMD_REPLACES[i].standalone && replaces > 0)
-                    continue;
-                else if (strstr(result, AMD_REPLACES[i].match))
-                {
-                    char *tmp = findReplace(result, inputSize,
-                        AMD_REPLACES[i].match, AMD_REPLACES[i].replacement);
-                    strncpy(result, tmp, inputSize - 1);
-                    result[inputSize - 1] = '\0';
-                    free(tmp);
-                    replaces++;
-                }
-            }
+            replaceAll(getReplacer(REPLACER_AMD), result, result, inputSize);
 
             if (strstr(result, "Ryzen") || strstr(result, "EPYC"))
             {
                 // Dynamically generate substrings like "16-Core" or "16
                 // Cores" to find and remove from AMD Ryzen or EPYC CPU
                 // names
-                int done = 0;
                 for (int i = 2; i <= 192; i += 2)
                 {
-                    if (done == 1)
-                        break;
-
-                    char *withDash = malloc(10);
-                    char *withSpace = malloc(11);
-                    if (!withDash || !withSpace) 
-                    {
-                        free(withDash);
-                        free(withSpace);
-                        continue;
-                    }
-                    
-                    snprintf(withDash, 10, " %d%s", i, "-Core");
-                    snprintf(withSpace, 11, " %d%s", i, " Cores");
+                    char withDash[10], withSpace[11];
+                    snprintf(withDash, sizeof(withDash), " %d%s", i, "-Core");
+                    snprintf(withSpace, sizeof(withSpace), " %d%s", i,
+                        " Cores");
 
                     if (strstr(result, withDash))
                     {
-                        done = 1;
-                        char *tmp = findErase(result, inputSize, withDash);
-                        strncpy(result, tmp, inputSize - 1);
-                        result[inputSize - 1] = '\0';
-                        free(tmp);
+                        findEraseIn(result, withDash);
+                        break;
                     }
                     else if (strstr(result, withSpace))
                     {
-                        done = 1;
-                        char *tmp = findErase(result, inputSize, withSpace);
-                        strncpy(result, tmp, inputSize - 1);
-                        result[inputSize - 1] = '\0';
-                        free(tmp);
+                        findEraseIn(result, withSpace);
+                        break;
                     }
-
-                    free(withDash);
-                    free(withSpace);
                 }
             }
             else if (strstr(result, "AMD [AMD/ATI]"))
-            {
-                char *tmp = findReplace(result, inputSize, "AMD [AMD/ATI]",
-                    "AMD/ATI");
-                strncpy(result, tmp, inputSize - 1);
-                result[inputSize - 1] = '\0';
-                free(tmp);
-            }
+                findReplaceIn(result, inputSize, "AMD [AMD/ATI]", "AMD/ATI");
         }
         // Apply Intel-specific replacements
         else if (strstr(result, "Intel"))
@@ -272,57 +225,17 @@ char *cleanCPUName(const CPU_ARCH arch, const char *input, int inputSize)
                 }
             }
 
-            int replaces = 0;
-            for (int i = 0; i < INTEL_REPLACES_LEN; i++)
-            {
-                if (INTEL_REPLACES[i].standalone && replaces > 0)
-                    continue;
-                else if (strstr(result, INTEL_REPLACES[i].match))
-                {
-                    char *tmp = findReplace(result, inputSize,
-                        INTEL_REPLACES[i].match,
-                        INTEL_REPLACES[i].replacement);
-                    strncpy(result, tmp, inputSize - 1);
-                    result[inputSize - 1] = '\0';
-                    free(tmp);
-                }
-            }
+            replaceAll(getReplacer(REPLACER_INTEL), result, result, inputSize);
         }
         // Apply IDT/Centaur-specific replacements
         else if (strstr(result, "IDT"))
         {
-            int replaces = 0;
-            for (int i = 0; i < IDT_REPLACES_LEN; i++)
-            {
-                if (IDT_REPLACES[i].standalone && replaces > 0)
-                    continue;
-                else if (strstr(result, IDT_REPLACES[i].match))
-                {
-                    char *tmp = findReplace(result, inputSize,
-                        IDT_REPLACES[i].match, IDT_REPLACES[i].replacement);
-                    strncpy(result, tmp, inputSize - 1);
-                    result[inputSize - 1] = '\0';
-                    free(tmp);
-                }
-            }
+            replaceAll(getReplacer(REPLACER_IDT), result, result, inputSize);
         }
         // Apply VIA-specific replacements
         else if (strstr(result, "VIA"))
         {
-            int replaces = 0;
-            for (int i = 0; i < VIA_REPLACES_LEN; i++)
-            {
-                if (VIA_REPLACES[i].standalone && replaces > 0)
-                    continue;
-                else if (strstr(result, VIA_REPLACES[i].match))
-                {
-                    char *tmp = findReplace(result, inputSize,
-                        VIA_REPLACES[i].match, VIA_REPLACES[i].replacement);
-                    strncpy(result, tmp, inputSize - 1);
-                    result[inputSize - 1] = '\0';
-                    free(tmp);
-                }
-            }
+            replaceAll(getReplacer(REPLACER_VIA), result, result, inputSize);
         }
     }
 
@@ -330,22 +243,8 @@ char *cleanCPUName(const CPU_ARCH arch, const char *input, int inputSize)
     if (COMPACT)
     {
         // Apply compact-specific CPU name shortenings
-        int replaces = 0;
-        for (int i = 0; i < COMPACT_CPU_REPLACES_LEN; i++)
-        {
-            if (COMPACT_CPU_REPLACES[i].standalone && replaces > 0)
-                continue;
-            else if (strstr(result, COMPACT_CPU_REPLACES[i].match))
-            {
-                char *tmp = findReplace(result, inputSize,
-                    COMPACT_CPU_REPLACES[i].match,
-                    COMPACT_CPU_REPLACES[i].replacement);
-                strncpy(result, tmp, inputSize - 1);
-                result[inputSize - 1] = '\0';
-                free(tmp);
-                replaces++;
-            }
-        }
+        replaceAll(getReplacer(REPLACER_COMPACT_CPU), result, result,
+            inputSize);
 
         strLen = strlen(result);
 
@@ -407,607 +306,934 @@ char *cleanCPUName(const CPU_ARCH arch, const char *input, int inputSize)
 #endif
 
 /**
- * Extracts CPU data from the given cpuinfo file and packs it into a
- * CPU_DATA struct for future processing and interpretation.
- * @param cpuInfo A file path to a cpuinfo file to read
- * @param gpuFromCPU A pointer to a string for returning an extracted GPU
- *        name
- * @return A CPU_DATA struct containing CPU data; NULL if no info found/
- *         error
+ * Finds a known CPU flag by its cpuinfo name.
+ * @param name The flag's name ("ht", "pae", etc.), which need not be
+ *             terminated
+ * @param len Length of the name
+ * @return The flag; CPU_FLAGS_LEN if it is not a known flag
  */
-CPU_DATA *getCPU(char *cpuInfo, char **gpuFromCPU)
+CPU_FLAG findCPUFlag(const char *name, const int len)
 {
-    if (!cpuInfo)
-        return NULL;
+    int low = 0, high = CPU_FLAGS_LEN;
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        const char *known = CPU_FLAG_NAMES[mid];
+        int i = 0;
+        while (i < len && known[i] == name[i])
+            i++;
+        // Longer names that start with this one come after it
+        int cmp = i < len ? (unsigned char)known[i] - (unsigned char)name[i] :
+            known[len] != '\0';
+        if (cmp < 0)
+            low = mid + 1;
+        else if (cmp > 0)
+            high = mid;
+        else
+            return mid;
+    }
+    return CPU_FLAGS_LEN;
+}
 
-    CPU_DATA *result = malloc(sizeof(CPU_DATA));
-    if (!result)
-        return NULL;
+/**
+ * Frees a CPU_DATA struct and the strings it holds.
+ * @param cpu CPU_DATA struct to free
+ */
+void freeCPU(CPU_DATA *cpu)
+{
+    if (!cpu) return;
+#ifndef X86_ONLY
+    free(cpu->processor);
+    free(cpu->uarch);
+    free(cpu->platform);
+    free(cpu->machine);
+    free(cpu->revisionStr);
+#endif
+    free(cpu->vendor);
+    free(cpu->name);
+    free(cpu->otherFlags);
+    free(cpu);
+}
+
+/**
+ * Sets a CPU's architecture if it has not been worked out yet.
+ * @param cpu CPU_DATA struct being filled in
+ * @param arch Architecture the field just read implies
+ */
+static void guessArch(CPU_DATA *cpu, const CPU_ARCH arch)
+{
+    if (cpu->arch == CPU_ARCH_UNKNOWN)
+        cpu->arch = arch;
+}
+
+/**
+ * Copies a cpuinfo value, cleaned the same way as extractFromPointInto.
+ * @param dst Buffer to copy to
+ * @param size Size of the buffer
+ * @param value Value to copy (everything after the key's ':'); NULL for none
+ * @return The buffer
+ */
+static char *copyCPUInfoValue(char *dst, const int size, const char *value)
+{
+    dst[0] = '\0';
+    if (!value)
+        return dst;
+
+    while (*value == ' ' || *value == '\t')
+        value++;
+    if (*value == '"')
+        value++;
+
+    int len = strnlen(value, size - 1);
+    memcpy(dst, value, len);
+    dst[len] = '\0';
+    if (len > 0 && dst[len - 1] == '"')
+        dst[len - 1] = '\0';
+    return dst;
+}
+
+/**
+ * @param size Size of the string to allocate
+ * @param value cpuinfo value to copy
+ * @return Newly allocated copy of the cleaned value; NULL if out of memory
+ */
+static char *dupCPUInfoValue(const int size, const char *value)
+{
+    char *result = malloc(size);
+    if (result)
+        copyCPUInfoValue(result, size, value);
+    return result;
+}
+
+/**
+ * @param cpu CPU_DATA struct being filled in
+ * @return 1 if no flags have been read yet; 0 if some have
+ */
+static int noFlags(const CPU_DATA *cpu)
+{
+    for (int i = 0; i < CPU_FLAG_WORDS; i++)
+        if (cpu->flags[i])
+            return 0;
+    return !cpu->otherFlags;
+}
+
+/**
+ * Reads a cpuinfo flags value into a CPU_DATA struct's flags, setting the
+ * bits of known flags and keeping the rest in otherFlags.
+ * @param cpu CPU_DATA struct being filled in
+ * @param value Space-separated flags; NULL for none
+ */
+static void readCPUFlags(CPU_DATA *cpu, const char *value)
+{
+    if (!value)
+        return;
+
+    int otherLen = 0;
+    for (;;)
+    {
+        while (isspace((unsigned char)*value))
+            value++;
+        const char *start = value;
+        while (*value && !isspace((unsigned char)*value))
+            value++;
+        int len = value - start;
+        if (len == 0)
+            break;
+
+        CPU_FLAG flag = findCPUFlag(start, len);
+        if (flag != CPU_FLAGS_LEN)
+        {
+            setFlag(cpu, flag);
+            continue;
+        }
+
+        // Unknown flags are rare, so room is only made once one is found,
+        // and then enough for the rest of the line
+        if (!cpu->otherFlags)
+        {
+            cpu->otherFlags = malloc(len + strlen(value) + 1);
+            if (!cpu->otherFlags)
+                continue;
+        }
+        if (otherLen > 0)
+            cpu->otherFlags[otherLen++] = ' ';
+        memcpy(cpu->otherFlags + otherLen, start, len);
+        otherLen += len;
+        cpu->otherFlags[otherLen] = '\0';
+    }
+}
 
-    *result = (CPU_DATA) {
-        .arch = CPU_ARCH_UNKNOWN,
-        .family = -1,
-        .model = -1,
-        .stepping = -1,
 #ifndef X86_ONLY
-        .revisionNo = -1,
+
+/**
+ * Checks a key is exactly the given name, ignoring any whitespace (e.g. that
+ * "cpu\t\t" is "cpu", but "cpu MHz" is not).
+ * @param key cpuinfo key
+ * @param name Name to check for
+ * @return 1 if the key is the name; 0 if not
+ */
+static int isBareKey(const char *key, const char *name)
+{
+    for (; *key; key++)
+    {
+        if (isspace((unsigned char)*key))
+            continue;
+        if (*key != *name++)
+            return 0;
+    }
+    return *name == '\0';
+}
+
 #endif
-        .freq = -1,
-        .index = 0,
-        .physIDs = (PHYS_IDS) {
-            .uniquePhysIDs = {0},
-            .noUniquePhysIDs = 0,
-            .maxPhysID = -1
-        },
-        .cores = -1,
-        .threads = -1,
-        .cacheSize = -1,
-        .flags[0] = '\0',
-        .physAddrSize = -1,
-        .virtAddrSize = -1
+
+/**
+ * @param line cpuinfo line
+ * @return Bit set of the CPUINFO_FIELDs the line's key matches
+ */
+static unsigned int matchCPUInfoFields(const char *line)
+{
+    unsigned int fields = 0;
+    for (int i = 0; i < CPUINFO_PREFIXES_LEN; i++)
+    {
+        const CPUINFO_PREFIX *prefix = &CPUINFO_PREFIXES[i];
+        if ((prefix->caseless ?
+            strncasecmp(line, prefix->prefix, prefix->len) :
+            strncmp(line, prefix->prefix, prefix->len)) == 0)
+            fields |= 1u << prefix->field;
+    }
+    return fields;
+}
+
+/**
+ * Finds the fields a cpuinfo line's key matches, remembering them for the
+ * next line with the same key.
+ * @param keys Hash table of keys seen so far
+ * @param line cpuinfo line
+ * @param keyLen Length of the line's key, including its ':' (if any)
+ * @param hash Hash of the line's key
+ * @return Bit set of the CPUINFO_FIELDs the line's key matches
+ */
+static unsigned int findCPUInfoFields(CPUINFO_KEY *keys, const char *line,
+    const int keyLen, const unsigned int hash)
+{
+    // Prefixes never extend past a ':', so a key's fields never depend on
+    // what follows it
+    if (keyLen == 0 || keyLen > CPUINFO_KEY_LEN)
+        return matchCPUInfoFields(line);
+
+    for (int i = 0; i < CPUINFO_KEYS_SIZE; i++)
+    {
+        CPUINFO_KEY *key = &keys[(hash + i) % CPUINFO_KEYS_SIZE];
+        if (key->len == 0)
+        {
+            key->hash = hash;
+            key->len = keyLen;
+            memcpy(key->key, line, keyLen);
+            key->fields = matchCPUInfoFields(line);
+            return key->fields;
+        }
+        if (key->hash == hash && key->len == keyLen &&
+            memcmp(key->key, line, keyLen) == 0)
+            return key->fields;
+    }
+
+    return matchCPUInfoFields(line);
+}
+
+/**
+ * Records a physical (package) ID.
+ * @param physIDs PHYS_IDS struct to record in
+ * @param val Physical ID
+ */
+static void addPhysID(PHYS_IDS *physIDs, const int val)
+{
+    if (physIDs->noUniquePhysIDs != IGNORE_UNIQUE_PHYS_IDS)
+    {
+        // Check if we already recorded this ID before
+        int found = 0;
+        for (int i = 0; i < physIDs->noUniquePhysIDs && !found; i++)
+            found = physIDs->uniquePhysIDs[i] == val;
+
+        // Record said ID if it's new
+        if (!found)
+        {
+            if (physIDs->noUniquePhysIDs < UNIQUE_PHYS_IDS_SIZE)
+                physIDs->uniquePhysIDs[physIDs->noUniquePhysIDs++] = val;
+            // If over the buffer size, mark this as unreliable instead of
+            // silently under-reporting it
+            else
+                physIDs->noUniquePhysIDs = IGNORE_UNIQUE_PHYS_IDS;
+        }
+    }
+
+    // Find the highest recorded value (+1 so it starts at 1)
+    if ((val + 1) > physIDs->maxPhysID)
+        physIDs->maxPhysID = (val + 1);
+}
+
+/**
+ * Reads a sysfs CPU list (e.g. "0-3,8,10-11") into a bit set.
+ * @param path Path to the list
+ * @param cpus Bit set of SYSFS_CPUS_MAX CPUs to add the listed CPUs to
+ * @return Highest CPU listed; -1 if unreadable, empty or too large
+ */
+static int readCPUList(const char *path, unsigned char *cpus)
+{
+    FILE *fStream = openFile(path, "r");
+    if (!fStream)
+        return -1;
+    char list[CPU_LIST_LEN];
+    int listed = fgets(list, sizeof(list), fStream) != NULL;
+    fclose(fStream);
+    if (!listed)
+        return -1;
+
+    int last = -1;
+    char *pos = list;
+    while (*pos >= '0' && *pos <= '9')
+    {
+        char *end;
+        int first = strtol(pos, &end, 10);
+        int final = first;
+        if (*end == '-')
+            final = strtol(end + 1, &end, 10);
+        if (final < first || final >= SYSFS_CPUS_MAX)
+            return -1;
+
+        for (int cpu = first; cpu <= final; cpu++)
+            cpus[cpu / 8] |= 1 << (cpu % 8);
+        if (final > last)
+            last = final;
+
+        pos = *end == ',' ? end + 1 : end;
+    }
+    return last;
+}
+
+/**
+ * Finds the processor index count and, if wanted, the physical IDs from
+ * sysfs, the same as reading every processor's block of cpuinfo would.
+ * @param result CPU_DATA struct being filled in
+ * @param physIDs Flags if the physical IDs should be found
+ * @return 1 if found; 0 if sysfs topology is unavailable
+ */
+static int readCPUTopology(CPU_DATA *result, const int physIDs)
+{
+    unsigned char online[SYSFS_CPUS_MAX / 8] = {0};
+    int last = readCPUList("/sys/devices/system/cpu/online", online);
+    if (last < 0)
+        return 0;
+
+    PHYS_IDS found = {
+        .uniquePhysIDs = {0},
+        .noUniquePhysIDs = 0,
+        .maxPhysID = -1
     };
+    // Each package is only visited once, from its first online CPU, so
+    // many-core packages cost no more to read than small ones
+    for (int cpu = 0; physIDs && cpu <= last; cpu++)
+    {
+        if (!(online[cpu / 8] & (1 << (cpu % 8))))
+            continue;
+
+        char path[PATH_MAX];
+        snprintf(path, PATH_MAX,
+            "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        FILE *fStream = openFile(path, "r");
+        if (!fStream)
+            return 0;
+        int val;
+        int scanned = fscanf(fStream, "%d", &val) == 1;
+        fclose(fStream);
+        if (!scanned)
+            return 0;
+        addPhysID(&found, val);
+
+        unsigned char package[SYSFS_CPUS_MAX / 8] = {0};
+        snprintf(path, PATH_MAX,
+            "/sys/devices/system/cpu/cpu%d/topology/package_cpus_list", cpu);
+        if (readCPUList(path, package) < 0)
+        {
+            // Older kernels only have the original name
+            snprintf(path, PATH_MAX,
+                "/sys/devices/system/cpu/cpu%d/topology/core_siblings_list",
+                cpu);
+            if (readCPUList(path, package) < 0)
+                return 0;
+        }
+        for (int i = 0; i < SYSFS_CPUS_MAX / 8; i++)
+            online[i] &= ~package[i];
+    }
 
+    result->index = last + 1;
+    if (physIDs)
+        result->physIDs = found;
+    return 1;
+}
 
+/**
+ * Reads a cpuinfo line into a CPU_DATA struct as the given field, unless the
+ * field has been found already.
+ * @param result CPU_DATA struct being filled in
+ * @param field Field the line's key matches
+ * @param key The line's key (everything before its ':')
+ * @param value The line's value (everything after its ':'); NULL if the line
+ *              has no ':'
+ * @return 1 if the line was read as the field; 0 if the field is already
+ *         known, so the line's next matching field should be tried
+ */
+static int readCPUInfoField(CPU_DATA *result, const CPUINFO_FIELD field,
+    const char *key, const char *value)
+{
+    char extract[NAME_LEN];
+#ifdef X86_ONLY
+    (void)key;
+#endif
 
-    FILE *fStream = fopen(cpuInfo, "r");
-    if (fStream)
+    switch (field)
     {
-        char buffer[CPUINFO_BUFFER_LEN];
-        while (fgets(buffer, sizeof(buffer), fStream))
+#ifndef X86_ONLY
+        // RISC-V: get micro architecture (uarch)
+        case CPUINFO_UARCH:
+            if (result->uarch) return 0;
+            guessArch(result, RISCV);
+            result->uarch = dupCPUInfoValue(UARCH_LEN, value);
+            return 1;
+#endif
+        // x86: get vendor ID
+        case CPUINFO_VENDOR_ID:
+            if (result->vendor) return 0;
+            guessArch(result, X86);
+            result->vendor = dupCPUInfoValue(VENDOR_LEN, value);
+            return 1;
+#ifndef X86_ONLY
+        // ARM: get CPU implementer name
+        case CPUINFO_IMPLEMENTER:
         {
+            if (result->vendor) return 0;
+            guessArch(result, ARM);
+
+            // Try to resolve the implementer name from the received hex value
+            copyCPUInfoValue(extract, 16, value);
+            char *end = NULL;
+            long val = strtol(extract, &end, 0);
+            if (end != extract && val >= 0 && val < 193 &&
+                ARM_IMPLEMENTERS[val])
+                result->vendor = dupCPUInfoValue(VENDOR_LEN,
+                    ARM_IMPLEMENTERS[val]);
+            return 1;
+        }
+#endif
+        // ARM/x86: get model name
+        case CPUINFO_MODEL_NAME:
+            if (result->name) return 0;
+            result->name = dupCPUInfoValue(NAME_LEN, value);
+            return 1;
 #ifndef X86_ONLY
-            // RISC-V: get micro architecture (uarch)
-            if (!result->uarch && strncasecmp(buffer, "uarch", 5) == 0)
-            {
-                char *extract = extractFromPoint(buffer, UARCH_LEN, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = RISCV;
-
-                    result->uarch = malloc(UARCH_LEN);
-                    strncpy(result->uarch, extract, UARCH_LEN - 1);
-                    result->uarch[UARCH_LEN - 1] = '\0';
-                    free(extract);
-                }
+        // ARM: get CPU architecture
+        case CPUINFO_ARCHITECTURE:
+            if (result->uarch) return 0;
+            guessArch(result, ARM);
+            copyCPUInfoValue(extract, NAME_LEN, value);
+            result->uarch = malloc(NAME_LEN);
+            if (result->uarch)
+            {
+                // If likely ARM version number
+                if (extract[0] >= '0' && extract[0] <= '9')
+                    snprintf(result->uarch, NAME_LEN, "ARMv%s", extract);
+                // If "AArch64", etc.
+                else
+                    snprintf(result->uarch, NAME_LEN, "%s", extract);
             }
-            // x86: get vendor ID
-            else if (!result->vendor &&
-                strncasecmp(buffer, "vendor_id", 9) == 0)
-#else
-            if (!result->vendor && strncasecmp(buffer, "vendor_id", 9) == 0)
+            return 1;
 #endif
+        // x86: get family number
+        case CPUINFO_FAMILY:
+            if (result->family != -1) return 0;
+            guessArch(result, X86);
+            result->family = atoi(copyCPUInfoValue(extract, 4, value));
+            return 1;
+#ifndef X86_ONLY
+        // MIPS: get CPU model name
+        case CPUINFO_CPU_MODEL:
+            if (result->name) return 0;
+            guessArch(result, MIPS);
+            result->name = dupCPUInfoValue(NAME_LEN, value);
+            return 1;
+        // ARM: get revision number
+        case CPUINFO_REVISION_NO:
+            if (result->revisionNo != -1) return 0;
+            guessArch(result, ARM);
+            result->revisionNo = atoi(copyCPUInfoValue(extract, 4, value));
+            return 1;
+        // m68k: get CPU model name
+        case CPUINFO_M68K_CPU:
+            if (result->name) return 0;
+            guessArch(result, M68K);
+            result->name = dupCPUInfoValue(NAME_LEN, value);
+            return 1;
+        // POWER: get CPU name
+        case CPUINFO_POWER_CPU:
+            if (result->name) return 0;
+            // Double-check the field is actually "cpu", not "cpu MHz", etc.
+            if (value && isBareKey(key, "cpu"))
             {
-                char *extract = extractFromPoint(buffer, VENDOR_LEN, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = X86;
+                guessArch(result, POWER);
+                result->name = dupCPUInfoValue(NAME_LEN, value);
 
-                    result->vendor = malloc(VENDOR_LEN);
-                    strncpy(result->vendor, extract, VENDOR_LEN - 1);
-                    result->vendor[VENDOR_LEN - 1] = '\0';
-                    free(extract);
-                }
+                // In cases like "..., altivec supported", we want to remove
+                // the comma and everything after
+                char *comma = result->name ? strchr(result->name, ',') : NULL;
+                if (comma)
+                    *comma = '\0';
             }
-#ifndef X86_ONLY
-            // ARM: get CPU implementer name
-            else if (!result->vendor &&
-                (strncasecmp(buffer, "cpu implementer", 15) == 0 ||
-                strncasecmp(buffer, "cpu implementor", 15) == 0))
+            return 1;
+        // RISC-V: get instruction set architecture (ISA)
+        case CPUINFO_ISA:
+            if (result->name) return 0;
+            copyCPUInfoValue(extract, NAME_LEN, value);
+            if (extract[0] == 'r' && extract[1] == 'v')
             {
-                char *extract = extractFromPoint(buffer, 16, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = ARM;
-
-                    // Try to resolve the implementer name from the received
-                    // hex value
-                    char *end = NULL;
-                    long val = strtol(extract, &end, 0);
-                    if (end != extract && val >= 0 && val <= 193 &&
-                        ARM_IMPLEMENTERS[val])
-                    {
-                        result->vendor = malloc(VENDOR_LEN);
-                        strncpy(result->vendor, ARM_IMPLEMENTERS[val],
-                            VENDOR_LEN - 1);
-                        result->vendor[VENDOR_LEN - 1] = '\0';
-                        free(extract);
-                    }
-                }
+                guessArch(result, RISCV);
+                result->name = dupCPUInfoValue(NAME_LEN, "RISC-V");
             }
+            return 1;
 #endif
-            // ARM/x86: get model name
-            else if (!result->name &&
-                strncasecmp(buffer, "model name", 10) == 0)
+        // x86: get model number
+        case CPUINFO_MODEL:
+            if (result->model != -1) return 0;
+            guessArch(result, X86);
+            result->model = atoi(copyCPUInfoValue(extract, 4, value));
+            return 1;
+        // x86: get stepping number
+        case CPUINFO_STEPPING:
+            if (result->stepping != -1) return 0;
+            copyCPUInfoValue(extract, 4, value);
+            if (extract[0] != 'u')
             {
-                char *extract = extractFromPoint(buffer, NAME_LEN, ':');
-                if (extract)
-                {
-                    result->name = malloc(NAME_LEN);
-                    strncpy(result->name, extract, NAME_LEN - 1);
-                    result->name[NAME_LEN - 1] = '\0';
-                    free(extract);
-                }
+                guessArch(result, X86);
+                result->stepping = atoi(extract);
             }
+            return 1;
+        // x86: get clock frequency in MHz
+        case CPUINFO_MHZ:
+            if (result->freq >= 0) return 0;
+            guessArch(result, X86);
+            result->freq = atof(copyCPUInfoValue(extract, 16, value));
+            return 1;
 #ifndef X86_ONLY
-            // ARM: get CPU architecture
-            else if (!result->uarch &&
-                strncasecmp(buffer, "CPU architecture", 16) == 0)
-            {
-                char *extract = extractFromPoint(buffer, NAME_LEN, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = ARM;
-
-                    result->uarch = malloc(NAME_LEN);
-                    // If likely ARM version number
-                    if (extract[0] >= '0' && extract[0] <= '9')
-                        snprintf(result->uarch, NAME_LEN, "ARMv%s",
-                        extract);
-                    // If "AArch64", etc.
-                    else
-                        snprintf(result->uarch, NAME_LEN, "%s", extract);
-                    free(extract);
-                }
-            }
+        // m68k: get clocking speed in MHz
+        case CPUINFO_CLOCKING:
+            if (result->freq >= 0) return 0;
+            guessArch(result, M68K);
+            result->freq = atof(copyCPUInfoValue(extract, 16, value));
+            return 1;
+        // POWER: get clock speed in MHz
+        case CPUINFO_CLOCK:
+            if (result->freq >= 0) return 0;
+            guessArch(result, POWER);
+            result->freq = atof(copyCPUInfoValue(extract, 16, value));
+            return 1;
+        // RISC-V: get clock speed in MHz
+        case CPUINFO_FREQ:
+            if (result->freq >= 0) return 0;
+            guessArch(result, RISCV);
+            // RISC-V CPU frequencies are in GHz but the rest of the code will
+            // expect MHz, so let's convert
+            result->freq = atof(copyCPUInfoValue(extract, 16, value)) * 1000;
+            return 1;
 #endif
-            // x86: get family number
-            else if (result->family == -1 &&
-                strncasecmp(buffer, "cpu family", 10) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 4, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = X86;
-
-                    result->family = atoi(extract);
-                    free(extract);
-                }
-            }
+        // All: get processor index count (must repeat to get the final value)
+        // OR ARM: get processor name
+        case CPUINFO_PROCESSOR:
+            copyCPUInfoValue(extract, PROCESSOR_LEN, value);
+            if (isNumeric(extract, -1))
+                result->index = (atoi(extract) + 1);
 #ifndef X86_ONLY
-            // MIPS: get CPU model name
-            else if (!result->name &&
-                strncasecmp(buffer, "cpu model", 9) == 0)
+            else
             {
-                char *extract = extractFromPoint(buffer, NAME_LEN, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = MIPS;
-
-                    result->name = malloc(NAME_LEN);
-                    strncpy(result->name, extract, NAME_LEN - 1);
-                    result->name[NAME_LEN - 1] = '\0';
-                    free(extract);
-                }
+                guessArch(result, ARM);
+                free(result->processor);
+                result->processor = dupCPUInfoValue(PROCESSOR_LEN, extract);
             }
-            // ARM: get revision number
-            else if (result->revisionNo == -1 &&
-                strncasecmp(buffer, "CPU revision", 12) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 4, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = ARM;
+#endif
+            return 1;
+        // x86: get maximum physical ID (must repeat to get the final value)
+        case CPUINFO_PHYS_ID:
+            addPhysID(&result->physIDs,
+                atoi(copyCPUInfoValue(extract, 5, value)));
+            return 1;
+        // x86: get physical core count
+        case CPUINFO_CORES:
+            if (result->cores != -1) return 0;
+            guessArch(result, X86);
+            result->cores = atoi(copyCPUInfoValue(extract, 5, value));
+            return 1;
+        // x86: get logical thread count
+        case CPUINFO_SIBLINGS:
+            if (result->threads != -1) return 0;
+            guessArch(result, X86);
+            result->threads = atoi(copyCPUInfoValue(extract, 5, value));
+            return 1;
+#ifndef X86_ONLY
+        // RISC-V: get hardware thread (hart) count
+        case CPUINFO_HART:
+            guessArch(result, RISCV);
+            result->threads = atoi(copyCPUInfoValue(extract, 5, value)) + 1;
+
+            // Whilst typically the exception and not the rule, some CPUs like
+            // SiFive Freedom U540 start from 1 instead of 0. If the hart count
+            // is more than 1 and is odd, we'll decrement it.
+            if (result->threads > 1 && result->threads % 2 != 0)
+                result->threads--;
+            return 1;
+#endif
+        // x86: get cache size in KB
+        case CPUINFO_CACHE_SIZE:
+            if (result->cacheSize != -1) return 0;
+            guessArch(result, X86);
+            result->cacheSize = atoi(copyCPUInfoValue(extract, 16, value));
+            return 1;
+        // x86: get CPU flags
+        case CPUINFO_FLAGS:
+            if (!noFlags(result)) return 0;
+            readCPUFlags(result, value);
+            return 1;
+        // x86: get physical and virtual address sizes
+        case CPUINFO_ADDRESS_SIZES:
+        {
+            if (result->physAddrSize != -1 && result->virtAddrSize != -1)
+                return 0;
+            guessArch(result, X86);
 
-                    result->revisionNo = atoi(extract);
-                    free(extract);
-                }
-            }
-            // m68k: get CPU model name
-            else if (!result->name && strncmp(buffer, "CPU:", 4) == 0)
+            int phys, virt;
+            if (sscanf(copyCPUInfoValue(extract, 32, value),
+                "%d bits physical, %d bits virtual", &phys, &virt) == 2)
             {
-                char *extract = extractFromPoint(buffer, NAME_LEN, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = M68K;
-
-                    result->name = malloc(NAME_LEN);
-                    strncpy(result->name, extract, NAME_LEN - 1);
-                    result->name[NAME_LEN - 1] = '\0';
-                    free(extract);
-                }
+                result->physAddrSize = phys;
+                result->virtAddrSize = virt;
             }
-            // POWER: get CPU name
-            else if (!result->name && strncmp(buffer, "cpu", 3) == 0)
+            return 1;
+        }
+#ifndef X86_ONLY
+        // POWER: get platform name
+        case CPUINFO_PLATFORM:
+            if (result->platform) return 0;
+            guessArch(result, POWER);
+            result->platform = dupCPUInfoValue(PLATFORM_LEN, value);
+            return 1;
+        // POWER: get machine name
+        case CPUINFO_MACHINE:
+            if (result->machine) return 0;
+            // Double-check the field is actually "machine"
+            if (value && isBareKey(key, "machine"))
             {
-                char *extract = extractFromPoint(buffer, NAME_LEN, ':');
-                // Strip the buffer of whitespace so we can double-check the
-                // field is actually "cpu:"
-                char stripped[NAME_LEN] = {0};
-                for (int i = 0, j = 0; buffer[i] && j < NAME_LEN - 1; i++)
-                    if (!isspace((unsigned char)buffer[i]))
-                        stripped[j++] = buffer[i];
-
-                if (extract && strncmp(stripped, "cpu:", 4) == 0)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = POWER;
-
-                    result->name = malloc(NAME_LEN);
-                    strncpy(result->name, extract, NAME_LEN - 1);
-                    free(extract);
-
-                    // In cases like "..., altivec supported", we want to
-                    // remove the comma and everything after
-                    char *comma = strchr(result->name, ',');
-                    if (comma)
-                        *comma = '\0';
-                }
+                guessArch(result, POWER);
+                result->machine = dupCPUInfoValue(MACHINE_LEN, value);
             }
-            // RISC-V: get instruction set architecture (ISA)
-            else if (!result->name && strncasecmp(buffer, "isa", 3) == 0)
+            return 1;
+        // POWER: get vendor name
+        case CPUINFO_VENDOR:
+            if (result->vendor) return 0;
+            // Double-check the field is actually "vendor"
+            if (value && isBareKey(key, "vendor"))
             {
-                char *extract = extractFromPoint(buffer, NAME_LEN, ':');
-                if (extract && extract[0] == 'r' && extract[1] == 'v')
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = RISCV;
-
-                    result->name = malloc(NAME_LEN);
-                    strncpy(result->name, "RISC-V", NAME_LEN - 1);
-                    result->name[NAME_LEN - 1] = '\0';
-                }
+                guessArch(result, POWER);
+                result->vendor = dupCPUInfoValue(VENDOR_LEN, value);
             }
+            return 1;
+        // POWER: get revision str
+        case CPUINFO_REVISION_STR:
+            if (result->revisionStr) return 0;
+            guessArch(result, POWER);
+            result->revisionStr = dupCPUInfoValue(REVISION_STR_LEN, value);
+            return 1;
 #endif
-            // x86: get model number
-            else if (result->model == -1 &&
-                strncasecmp(buffer, "model", 5) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 4, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = X86;
+        default:
+            return 0;
+    }
+}
 
-                    result->model = atoi(extract);
-                    free(extract);
-                }
-            }
-            // x86: get stepping number
-            else if (result->stepping == -1 &&
-                strncasecmp(buffer, "stepping", 8) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 4, ':');
-                if (extract && extract[0] != 'u')
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = X86;
+/**
+ * Reads a cpuinfo line into a CPU_DATA struct.
+ * @param result CPU_DATA struct being filled in
+ * @param keys Hash table of keys seen so far
+ * @param line cpuinfo line (split in place)
+ */
+static void readCPUInfoLine(CPU_DATA *result, CPUINFO_KEY *keys, char *line)
+{
+    // FNV-1a hash of the key, found while looking for its end
+    unsigned int hash = 2166136261u;
+    char *end = line;
+    for (; *end && *end != ':'; end++)
+        hash = (hash ^ (unsigned char)*end) * 16777619u;
+    if (*end == ':')
+        hash = (hash ^ (unsigned char)*end++) * 16777619u;
+
+    unsigned int fields = findCPUInfoFields(keys, line, end - line, hash);
+    if (!fields)
+        return;
+
+    const char *value = NULL;
+    if (end > line && end[-1] == ':')
+    {
+        end[-1] = '\0';
+        value = end;
+    }
 
-                    result->stepping = atoi(extract);
-                    free(extract);
-                }
-            }
-            // x86: get clock frequency in MHz
-            else if (result->freq < 0 &&
-                strncasecmp(buffer, "cpu mhz", 7) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 16, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = X86;
+    // Like an else-if chain, the line is only read as its first field that
+    // has not been found yet
+    for (int field = 0; fields; field++, fields >>= 1)
+        if ((fields & 1) && readCPUInfoField(result, field, line, value))
+            break;
+}
 
-                    result->freq = atof(extract);
-                    free(extract);
-                }
-            }
-#ifndef X86_ONLY
-            // m68k: get clocking speed in MHz
-            else if (result->freq < 0 &&
-                strncasecmp(buffer, "clocking", 8) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 16, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = M68K;
+/**
+ * Reads a cpuinfo file into a CPU_DATA struct.
+ * @param result Initialised CPU_DATA struct to fill in
+ * @param cpuInfo A file path to a cpuinfo file to read
+ * @return 1 if read; 0 if the file could not be read
+ */
+static int readCPUInfo(CPU_DATA *result, const char *cpuInfo)
+{
+    int fd = openFileAt(AT_FDCWD, cpuInfo, O_RDONLY);
+    if (fd < 0)
+        return 0;
 
-                    result->freq = atof(extract);
-                    free(extract);
-                }
-            }
-            // POWER: get clock speed in MHz
-            else if (result->freq < 0 &&
-                strncasecmp(buffer, "clock", 5) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 16, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = POWER;
+    char *block = malloc(CPUINFO_BLOCK_LEN);
+    if (!block)
+    {
+        close(fd);
+        return 0;
+    }
+    CPUINFO_KEY keys[CPUINFO_KEYS_SIZE] = {{0}};
+
+    // On x86, every processor's block is the same bar its processor and
+    // physical IDs, which sysfs can give us far quicker on many-core
+    // machines. This is only done for the system's own cpuinfo, as others
+    // (e.g. cpuinfo-ds) describe a different machine to sysfs, and only if
+    // cpuinfo is too big for one block, as smaller ones are quicker to read
+    // whole.
+    int topology = strcmp(cpuInfo, "/proc/cpuinfo") == 0;
+    int done = 0;
+
+    // cpuinfo can be over a megabyte on many-core machines, so it is read in
+    // large blocks and split into lines in place
+    int len = 0;
+    int skipping = 0;
+    ssize_t got;
+    while (!done &&
+        (got = read(fd, block + len, CPUINFO_BLOCK_LEN - 1 - len)) > 0)
+    {
+        if (len + got < CPUINFO_BLOCK_LEN - 1)
+            topology = 0;
+
+        char *line = block;
+        char *blockEnd = block + len + got;
+        char *newline;
+        while (!done &&
+            (newline = memchr(line, '\n', blockEnd - line)) != NULL)
+        {
+            *newline = '\0';
+            // A blank line ends a processor's block
+            if (topology && line[0] == '\0' && result->index > 0)
+            {
+                topology = 0;
+                if (result->arch == X86)
+                    done = readCPUTopology(result,
+                        result->physIDs.maxPhysID != -1);
+            }
+            else if (!skipping)
+                readCPUInfoLine(result, keys, line);
+            skipping = 0;
+            line = newline + 1;
+        }
 
-                    result->freq = atof(extract);
-                    free(extract);
-                }
-            }
-            // RISC-V: get clock speed in MHz
-            else if (result->freq < 0 &&
-                strncasecmp(buffer, "cpu-freq", 8) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 16, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = RISCV;
+        len = blockEnd - line;
+        // A line too long for the block is read as far as it fits
+        if (len == CPUINFO_BLOCK_LEN - 1)
+        {
+            block[len] = '\0';
+            if (!skipping)
+                readCPUInfoLine(result, keys, block);
+            skipping = 1;
+            len = 0;
+        }
+        else
+            memmove(block, line, len);
+    }
+    if (!done && len > 0 && !skipping)
+    {
+        block[len] = '\0';
+        readCPUInfoLine(result, keys, block);
+    }
+    close(fd);
+    free(block);
 
-                    // RISC-V CPU frequencies are in GHz but the rest of the
-                    // code will expect MHz, so let's convert
-                    result->freq = atof(extract) * 1000;
-                    free(extract);
-                }
-            }
-#endif
-            // All: get processor index count (must repeat to get the final
-            // value) OR ARM: get processor name
-            else if (strncasecmp(buffer, "processor", 9) == 0)
-            {
-                char *extract = extractFromPoint(buffer, PROCESSOR_LEN,
-                    ':');
-                if (extract)
-                {
-                    if (isNumeric(extract, -1))
-                        result->index = (atoi(extract) + 1);
-#ifndef X86_ONLY
-                    else
-                    {
-                        if (result->arch == CPU_ARCH_UNKNOWN)
-                            result->arch = ARM;
+    return 1;
+}
 
-                        result->processor = malloc(PROCESSOR_LEN);
-                        strncpy(result->processor, extract,
-                            PROCESSOR_LEN - 1);
-                        result->processor[PROCESSOR_LEN - 1] = '\0';
-                    }
-#endif
-                    free(extract);
-                }
-            }
-            // x86: get maximum physical ID (must repeat to get the final
-            // value)
-            else if (strncasecmp(buffer, "physical id", 11) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 5, ':');
-                if (extract)
-                {
-                    int val = atoi(extract);
+/**
+ * @param vendor Canonical vendor name (see VENDOR_ALIASES); NULL if unknown
+ * @return The x86 vendor that CPU_RULES know the vendor as
+ */
+static X86_VENDOR findX86Vendor(const char *vendor)
+{
+    if (!vendor)
+        return X86_VENDOR_OTHER;
+    if (vendor[0] == 'A')
+        return X86_VENDOR_AMD;
+    if (vendor[0] == 'C' && vendor[1] == 'e')
+        return X86_VENDOR_CENTAUR;
+    if (vendor[0] == 'C' && vendor[1] == 'y')
+        return X86_VENDOR_CYRIX;
+    if (vendor[0] == 'I' && vendor[1] == 'n')
+        return X86_VENDOR_INTEL;
+    return X86_VENDOR_OTHER;
+}
 
-                    if (result->physIDs.noUniquePhysIDs !=
-                        IGNORE_UNIQUE_PHYS_IDS)
-                    {
-                        // Check if we already recorded this ID before
-                        int found = 0;
-                        for (int i = 0; i < result->physIDs.noUniquePhysIDs;
-                            i++)
-                        {
-                            if (result->physIDs.uniquePhysIDs[i] == val)
-                            {
-                                found = 1;
-                                break;
-                            }
-                        }
+/**
+ * @param value Value to check
+ * @param min Lowest value allowed; CPU_RULE_ANY for no limit
+ * @param max Highest value allowed; CPU_RULE_ANY for no limit
+ * @return 1 if the value is in range; 0 if not
+ */
+static int isInRuleRange(const int value, const int min, const int max)
+{
+    return (min == CPU_RULE_ANY || value >= min) &&
+        (max == CPU_RULE_ANY || value <= max);
+}
 
-                        // Record said ID if it's new
-                        if (!found)
-                        {
-                            if (result->physIDs.noUniquePhysIDs <
-                                UNIQUE_PHYS_IDS_SIZE)
-                                result->physIDs.uniquePhysIDs[
-                                    result->physIDs.noUniquePhysIDs++
-                                ] = val;
-                            // If over the buffer size, mark this as
-                            // unreliable instead of silently under-
-                            // reporting it
-                            else
-                                result->physIDs.noUniquePhysIDs = 
-                                    IGNORE_UNIQUE_PHYS_IDS;
-                        }
-                    }
+/**
+ * Applies the CPU_RULES that match a CPU, in order.
+ * @param cpu CPU_DATA struct to correct
+ * @param vendor The CPU's vendor
+ */
+static void applyCPURules(CPU_DATA *cpu, const X86_VENDOR vendor)
+{
+    // Find the first rule for the CPU's vendor and family
+    int low = 0, high = CPU_RULES_LEN;
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (CPU_RULES[mid].vendor < vendor ||
+            (CPU_RULES[mid].vendor == vendor &&
+            CPU_RULES[mid].family < cpu->family))
+            low = mid + 1;
+        else
+            high = mid;
+    }
 
-                    // Find the highest recorded value (+1 so it starts at
-                    // 1)
-                    if ((val + 1) > result->physIDs.maxPhysID)
-                        result->physIDs.maxPhysID = (val + 1);
+    // Rules are sorted by lowest model, so there are no more for this CPU
+    // once one starts past its model
+    for (int i = low; i < CPU_RULES_LEN; i++)
+    {
+        const CPU_RULE *rule = &CPU_RULES[i];
+        if (rule->vendor != vendor || rule->family != cpu->family ||
+            rule->modelMin > cpu->model)
+            break;
+
+        if (!isInRuleRange(cpu->model, rule->modelMin, rule->modelMax) ||
+            !isInRuleRange(cpu->stepping, rule->steppingMin,
+                rule->steppingMax) ||
+            !isInRuleRange(cpu->cacheSize, rule->cacheMin, rule->cacheMax) ||
+            (rule->freqMin != CPU_RULE_ANY && cpu->freq < rule->freqMin) ||
+            (rule->freqMax != CPU_RULE_ANY && cpu->freq >= rule->freqMax) ||
+            !isInRuleRange(cpu->index, rule->minIndex, CPU_RULE_ANY))
+            continue;
+
+#ifdef TESTS
+        CPU_RULE_HITS[i]++;
+#endif
+        switch (rule->action)
+        {
+            case CPU_RULE_NAME:
+                if (!cpu->name)
+                    cpu->name = malloc(NAME_LEN);
+                if (cpu->name)
+                    snprintf(cpu->name, NAME_LEN, "%s", rule->text);
+                break;
 
-                    free(extract);
-                }
-            }
-            // x86: get physical core count
-            else if (result->cores == -1 &&
-                strncasecmp(buffer, "cpu cores", 9) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 5, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = X86;
+            case CPU_RULE_APPEND:
+                if (cpu->name)
+                    strncat(cpu->name, rule->text,
+                        NAME_LEN - strlen(cpu->name) - 1);
+                break;
 
-                    result->cores = atoi(extract);
-                    free(extract);
-                }
-            }
-            // x86: get logical thread count
-            else if (result->threads == -1 &&
-                (strncasecmp(buffer, "siblings", 8) == 0 ||
-                strncasecmp(buffer, "Number of siblings", 18) == 0))
-            {
-                char *extract = extractFromPoint(buffer, 5, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = X86;
+            case CPU_RULE_SINGLE_CORE:
+                if (cpu->cores == -1 && cpu->threads == -1)
+                    cpu->cores = cpu->threads = 1;
+                break;
+        }
+    }
+}
 
-                    result->threads = atoi(extract);
-                    free(extract);
-                }
-            }
-#ifndef X86_ONLY
-            // RISC-V: get hardware thread (hart) count
-            else if (strncasecmp(buffer, "hart", 4) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 5, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = RISCV;
-
-                    result->threads = atoi(extract) + 1;
-                    free(extract);
-
-                    // Whilst typically the exception and not the rule, some
-                    // CPUs like SiFive Freedom U540 start from 1 instead of
-                    // 0. If the hart count is more than 1 and is odd, we'll
-                    // decrement it.
-                    if (result->threads > 1 && result->threads % 2 != 0)
-                        result->threads--;
-                }
-            }
-#endif
-            // x86: get cache size in KB
-            else if (result->cacheSize == -1 &&
-                strncasecmp(buffer, "cache size", 10) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 16, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = X86;
+/**
+ * Extracts CPU data from the given cpuinfo file and packs it into a
+ * CPU_DATA struct for future processing and interpretation.
+ * @param cpuInfo A file path to a cpuinfo file to read
+ * @param gpuFromCPU A pointer to a string for returning an extracted GPU
+ *        name
+ * @return A CPU_DATA struct containing CPU data; NULL if no info found/
+ *         error
+ */
+CPU_DATA *getCPU(char *cpuInfo, char **gpuFromCPU)
+{
+    if (!cpuInfo)
+        return NULL;
 
-                    result->cacheSize = atoi(extract);
-                    free(extract);
-                }
-            }
-            // x86: get CPU flags
-            else if (result->flags[0] == '\0' &&
-                strncasecmp(buffer, "flags", 5) == 0)
-            {
-                char *extract = extractFromPoint(buffer, FLAGS_LEN, ':');
-                if (extract)
-                {
-                    strncpy(result->flags, extract, FLAGS_LEN - 1);
-                    result->flags[FLAGS_LEN - 1] = '\0';
-                    free(extract);
-                }
-            }
-            // x86: get physical and virtual address sizes
-            else if ((result->physAddrSize == -1 || 
-                result->virtAddrSize == -1) &&
-                strncasecmp(buffer, "address sizes", 13) == 0)
-            {
-                char *extract = extractFromPoint(buffer, 32, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = X86;
+    CPU_DATA *result = malloc(sizeof(CPU_DATA));
+    if (!result)
+        return NULL;
 
-                    int phys, virt;
-                    if (sscanf(extract, "%d bits physical, %d bits virtual",
-                        &phys, &virt) == 2)
-                    {
-                        result->physAddrSize = phys;
-                        result->virtAddrSize = virt;
-                    }
-                    free(extract);
-                }
-            }
+    *result = (CPU_DATA) {
+        .arch = CPU_ARCH_UNKNOWN,
+        .family = -1,
+        .model = -1,
+        .stepping = -1,
 #ifndef X86_ONLY
-            // POWER: get platform name
-            else if (!result->platform &&
-                strncasecmp(buffer, "platform", 8) == 0)
-            {
-                char *extract = extractFromPoint(buffer, PLATFORM_LEN, ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = POWER;
+        .revisionNo = -1,
+#endif
+        .freq = -1,
+        .index = 0,
+        .physIDs = (PHYS_IDS) {
+            .uniquePhysIDs = {0},
+            .noUniquePhysIDs = 0,
+            .maxPhysID = -1
+        },
+        .cores = -1,
+        .threads = -1,
+        .cacheSize = -1,
+        .flags = {0},
+        .otherFlags = NULL,
+        .physAddrSize = -1,
+        .virtAddrSize = -1
+    };
 
-                    result->platform = malloc(PLATFORM_LEN);
-                    strncpy(result->platform, extract, PLATFORM_LEN - 1);
-                    result->platform[PLATFORM_LEN - 1] = '\0';
-                }
-            }
-            // POWER: get machine name
-            else if (!result->machine &&
-                strncasecmp(buffer, "machine", 7) == 0)
-            {
-                char *extract = extractFromPoint(buffer, MACHINE_LEN, ':');
-                // Strip the buffer of whitespace so we can double-check the
-                // field is actually "machine:"
-                char stripped[MACHINE_LEN] = {0};
-                for (int i = 0, j = 0; buffer[i] && j < MACHINE_LEN - 1;
-                    i++)
-                    if (!isspace((unsigned char)buffer[i]))
-                        stripped[j++] = buffer[i];
-
-                if (extract && strncmp(stripped, "machine:", 8) == 0)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = POWER;
 
-                    result->machine = malloc(MACHINE_LEN);
-                    strncpy(result->machine, extract, MACHINE_LEN - 1);
-                    result->machine[MACHINE_LEN - 1] = '\0';
-                }
-            }
-            // POWER: get vendor name
-            else if (!result->vendor &&
-                (strncasecmp(buffer, "vendor", 6) == 0))
-            {
-                char *extract = extractFromPoint(buffer, 16, ':');
-                // Strip the buffer of whitespace so we can double-check the
-                // field is actually "vendor:"
-                char stripped[VENDOR_LEN] = {0};
-                for (int i = 0, j = 0; buffer[i] && j < VENDOR_LEN - 1; i++)
-                    if (!isspace((unsigned char)buffer[i]))
-                        stripped[j++] = buffer[i];
-
-                if (extract && strncmp(stripped, "vendor:", 7) == 0)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = POWER;
 
-                    result->vendor = malloc(VENDOR_LEN);
-                    strncpy(result->vendor, extract, VENDOR_LEN - 1);
-                    result->vendor[VENDOR_LEN - 1] = '\0';
-                }
-            }
-            // POWER: get revision str
-            else if (!result->revisionStr &&
-                (strncasecmp(buffer, "revision", 6) == 0))
+    // The CPU we are running on can identify itself with CPUID far quicker
+    // than cpuinfo can be read, bar its processor index count and physical
+    // IDs, which come from sysfs. Other cpuinfo files (e.g. cpuinfo-ds) are
+    // always read, so they still test reading cpuinfo.
+    int identified = 0;
+    if (!getSysroot() && strcmp(cpuInfo, "/proc/cpuinfo") == 0)
+    {
+        CPU_DATA blank = *result;
+        if (readCPUID(result))
+        {
+            identified = readCPUTopology(result, 1);
+            if (!identified)
             {
-                char *extract = extractFromPoint(buffer, REVISION_STR_LEN,
-                    ':');
-                if (extract)
-                {
-                    if (result->arch == CPU_ARCH_UNKNOWN)
-                        result->arch = POWER;
-
-                    result->revisionStr = malloc(REVISION_STR_LEN);
-                    strncpy(result->revisionStr, extract,
-                        REVISION_STR_LEN - 1);
-                    result->revisionStr[REVISION_STR_LEN - 1] = '\0';
-                }
+                free(result->vendor);
+                free(result->name);
+                *result = blank;
             }
-#endif
         }
-        fclose(fStream);
     }
-    else 
+
+    if (!identified && !readCPUInfo(result, cpuInfo))
     {
-#ifndef X86_ONLY
-        free(result->processor);
-        free(result->uarch);
-        free(result->platform);
-        free(result->machine);
-#endif
-        free(result->vendor);
-        free(result->name);
         free(result);
         return NULL;
     }
@@ -1016,7 +1242,7 @@ CPU_DATA *getCPU(char *cpuInfo, char **gpuFromCPU)
 
 #ifndef NO_STR_CLEANING
 
-    if (result->arch == X86)
+    if (result->arch == X86 && result->name)
     {
         // If the model name has GPU name in it, we will extract it and save
         // if for later in case we need it as a fallback when GPU detection
@@ -1087,40 +1313,31 @@ CPU_DATA *getCPU(char *cpuInfo, char **gpuFromCPU)
     return result;
 }
 
+/**
+ * Finds which x86-64 microarchitecture level (as in x86-64-v2, etc.) a CPU
+ * meets from its flags.
+ * @param cpu Initialised CPU_DATA struct containing the flags to check
+ * @return Level from 1 to 4; 0 if not an x86-64 CPU or no flags were found
+ */
+int getISALevel(const CPU_DATA *cpu)
+{
+    int level = 4;
+    for (int i = 0; i < X86_64_LEVEL_FLAGS_LEN && level > 0; i++)
+        if (X86_64_LEVEL_FLAGS[i].level <= level &&
+            !hasFlag(cpu, X86_64_LEVEL_FLAGS[i].flag))
+            level = X86_64_LEVEL_FLAGS[i].level - 1;
+    return level;
+}
+
 /**
  * Checks if the given CPU flag is present in the captured data.
- * @param cpu Initialised CPU_DATA struct containing the flags string to
- *            search
- * @param flag The flag to find ("ht", "pae", etc.)
+ * @param cpu Initialised CPU_DATA struct containing the flags to check
+ * @param flag The flag to find (CPU_FLAG_HT, CPU_FLAG_PAE, etc.)
  * @return 1 if flag found; 0 if not found or no data
  */
-int hasFlag(const CPU_DATA *cpu, const char *flag)
+int hasFlag(const CPU_DATA *cpu, const CPU_FLAG flag)
 {
-    // No flags were found, so let's exit...
-    if (cpu->flags[0] == '\0')
-        return 0;
-
-    const char *needle = cpu->flags;
-    int flagLen = strlen(flag);
-
-    while ((needle = strstr(needle, flag)))
-    {
-        // Unless we're at the end of the flags string, we want to search
-        // for the flag with spaces surrounding it so we don't match "sse2"
-        // when we want "sse" (etc.). If we're at the start of the flags
-        // string, we add a "fake" space so the boundary check doesn't read
-        // before the buffer
-        char before = (needle == cpu->flags) ? ' ' : *(needle - 1);
-        char after  = *(needle + flagLen);
-
-        if (before == ' ' && (after == ' ' || after == '\0' ||
-            after == '\n'))
-            return 1;
-
-        needle += flagLen;
-    }
-
-    return 0;
+    return (cpu->flags[flag / 32] >> (flag % 32)) & 1;
 }
 
 /**
@@ -1213,22 +1430,15 @@ char *interpretCPU(CPU_DATA *cpu)
         {
 #ifndef NO_STR_CLEANING
             // Remove any existing bracketed content
-            char *tmp = removeBrackets(cpu->name, NAME_LEN);
-            if (tmp)
-            {
-                free(cpu->name);
-                cpu->name = tmp;
-            }
+            removeBracketsIn(cpu->name);
 #endif
 
             // If absent, add the revision number in
             if (cpu->revisionNo != -1 && !strstr(cpu->name, " rev "))
             {
-                char *tmp = malloc(NAME_LEN);
-                snprintf(tmp, NAME_LEN, "%s rev %d", cpu->name,
+                int len = strlen(cpu->name);
+                snprintf(cpu->name + len, NAME_LEN - len, " rev %d",
                     cpu->revisionNo);
-                free(cpu->name);
-                cpu->name = tmp;
             }
 
             // If the uarch name hasn't already been added, add it in
@@ -1238,10 +1448,9 @@ char *interpretCPU(CPU_DATA *cpu)
                 !strstr(cpu->name, cpu->uarch) &&
                 cpu->uarch && cpu->uarch[0] != '\0')
             {
-                char *tmp = malloc(NAME_LEN);
-                snprintf(tmp, NAME_LEN, "%s (%s)", cpu->name, cpu->uarch);
-                free(cpu->name);
-                cpu->name = tmp;
+                int len = strlen(cpu->name);
+                snprintf(cpu->name + len, NAME_LEN - len, " (%s)",
+                    cpu->uarch);
             }
         }
     }
@@ -1259,12 +1468,7 @@ char *interpretCPU(CPU_DATA *cpu)
 #ifndef NO_STR_CLEANING
         // Remove any existing bracketed content like "(gs)", "(raw)",
         // "(architected)", etc.
-        char *tmp = removeBrackets(cpu->name, NAME_LEN);
-        if (tmp)
-        {
-            free(cpu->name);
-            cpu->name = tmp;
-        }
+        removeBracketsIn(cpu->name);
 #endif
 
         // IBM pSeries and PowerNV customisations
@@ -1289,36 +1493,17 @@ char *interpretCPU(CPU_DATA *cpu)
                 snprintf(cpu->vendor, VENDOR_LEN, "STI");
             
             // Contract "Broadband Engine" to "/B.E." to save length
-            char *tmp = findReplace(cpu->name, NAME_LEN,
-                " Broadband Engine", "/B.E.");
-            if (tmp)
-            {
-                free(cpu->name);
-                cpu->name = tmp;
-                tmp = NULL;
-            }
+            findReplaceIn(cpu->name, NAME_LEN, " Broadband Engine", "/B.E.");
 
             // See if we can add the a cue to what host this Cell is being
             // used for (e.g., Sony PS3, IBM CHRP)
-            tmp = malloc(NAME_LEN);
-            if (tmp)
-            {
-                tmp[0] = '\0';
-                if (cpu->platform &&
-                    strcmp(cpu->platform, "PS3") == 0)
-                    snprintf(tmp, NAME_LEN, "%s (Sony PS3)", cpu->name);
-                else if (cpu->machine &&
-                    strncmp(cpu->machine, "CHRP IBM", 8) == 0)
-                    snprintf(tmp, NAME_LEN, "%s (IBM CHRP)", cpu->name);
-
-                if (tmp[0] != '\0')
-                {
-                    free(cpu->name);
-                    cpu->name = tmp;
-                }
-                else
-                    free(tmp);
-            }
+            if (cpu->platform && strcmp(cpu->platform, "PS3") == 0)
+                strncat(cpu->name, " (Sony PS3)",
+                    NAME_LEN - strlen(cpu->name) - 1);
+            else if (cpu->machine &&
+                strncmp(cpu->machine, "CHRP IBM", 8) == 0)
+                strncat(cpu->name, " (IBM CHRP)",
+                    NAME_LEN - strlen(cpu->name) - 1);
         }
         // Motorola customisations
         else if ((cpu->vendor && strstr(cpu->vendor, "Motorola") != 0) ||
@@ -1326,13 +1511,7 @@ char *interpretCPU(CPU_DATA *cpu)
         {
             // Remove redundant "MCG" from vendor name if it already
             // contains "Motorola"
-            char *tmp = findReplace(cpu->vendor, VENDOR_LEN, "Motorola MCG",
-                "Motorola");
-            if (tmp)
-            {
-                free(cpu->vendor);
-                cpu->vendor = tmp;
-            }
+            findReplaceIn(cpu->vendor, VENDOR_LEN, "Motorola MCG", "Motorola");
 
             // If the machine name contains an "MCP" model number, we can
             // use it as the canonical model name
@@ -1455,13 +1634,7 @@ char *interpretCPU(CPU_DATA *cpu)
                 if (cpu->vendor)
                     snprintf(cpu->vendor, VENDOR_LEN, "IBM");
                 
-                char *tmp = findReplace(cpu->name, NAME_LEN, "IBM 4",
-                    "PowerPC 4");
-                if (tmp)
-                {
-                    free(cpu->name);
-                    cpu->name = tmp;
-                }
+                findReplaceIn(cpu->name, NAME_LEN, "IBM 4", "PowerPC 4");
             }
             // For Apple, if we know the CPU should be G3, G4 or G5, we
             // should construct the model containing Gx and the IBM model
@@ -1533,29 +1706,32 @@ char *interpretCPU(CPU_DATA *cpu)
             }
         }
 
+        // Corrections decided by the CPU's numbers alone come from
+        // CPU_RULES; those below also depend on its name
+        X86_VENDOR vendor = findX86Vendor(cpu->vendor);
+        applyCPURules(cpu, vendor);
+
         // 486
         if (cpu->family == 4)
         {
-            if (cpu->vendor[0] == 'C' && cpu->vendor[1] == 'y')
+            if (vendor == X86_VENDOR_CYRIX)
             {
                 // If we have a Cx486Dxxx with FPU, make sure 387 is
                 // included in the model name
                 if ((strstr(cpu->name, "Cx486DLC") ||
-                    strstr(cpu->name, "Cx486DRx2")) && hasFlag(cpu, "fpu"))
+                    strstr(cpu->name, "Cx486DRx2")) &&
+                    hasFlag(cpu, CPU_FLAG_FPU))
                 {
-                    char *tmp = malloc(NAME_LEN);
-                    snprintf(tmp, NAME_LEN, "%s + 387", cpu->name);
-                    free(cpu->name);
-                    cpu->name = tmp;
+                    strncat(cpu->name, " + 387",
+                        NAME_LEN - strlen(cpu->name) - 1);
                 }
                 // If we have a Cx486S with FPU, make sure 487 is included
                 // in the  model name
-                else if (strstr(cpu->name, "Cx486S") && hasFlag(cpu, "fpu"))
+                else if (strstr(cpu->name, "Cx486S") &&
+                    hasFlag(cpu, CPU_FLAG_FPU))
                 {
-                    char *tmp = malloc(NAME_LEN);
-                    snprintf(tmp, NAME_LEN, "%s + 487", cpu->name);
-                    free(cpu->name);
-                    cpu->name = tmp;
+                    strncat(cpu->name, " + 487",
+                        NAME_LEN - strlen(cpu->name) - 1);
                 }
             }
             else
@@ -1568,7 +1744,7 @@ char *interpretCPU(CPU_DATA *cpu)
                     cpu->vendor[0] == 'u') && cpu->name[0] != '\0' &&
                     strcmp(cpu->name, "486") == 0)
                 {
-                    if (hasFlag(cpu, "fpu"))
+                    if (hasFlag(cpu, CPU_FLAG_FPU))
                         snprintf(cpu->name, NAME_LEN,
                             "486DX/487SX/486SX + 387");
                     else
@@ -1579,128 +1755,40 @@ char *interpretCPU(CPU_DATA *cpu)
         // Pentium/P5 and K6
         else if (cpu->family == 5)
         {
-            if (cpu->vendor[0] == 'A')
+            if (vendor == X86_VENDOR_AMD)
             {
-                // If we have a K6, we will try to distinguish if it's a
-                // Model 6 or Model 7
-                if (cpu->model == 6)
-                {
-                    char *tmp = malloc(NAME_LEN);
-                    snprintf(tmp, NAME_LEN, "AMD K6 (Model 6)");
-                    free(cpu->name);
-                    cpu->name = tmp;
-                }
-                else if (cpu->model == 7)
-                {
-                    char *tmp = malloc(NAME_LEN);
-                    snprintf(tmp, NAME_LEN, "AMD K6 (Model 7)");
-                    free(cpu->name);
-                    cpu->name = tmp;
-                }
                 // If we have a Geode LX, we replace its long but unspecific
                 // name with the correct model based on frequency
-                else if (cpu->model == 10 && cpu->name[0] == 'G')
+                if (cpu->model == 10 && cpu->name[0] == 'G')
                 {
-                    char *tmp = malloc(NAME_LEN);
                     // LX 600 (366MHz)
                     if (cpu->freq >= 350 && cpu->freq <= 380)
-                        snprintf(tmp, NAME_LEN, "AMD Geode LX 600");
+                        snprintf(cpu->name, NAME_LEN, "AMD Geode LX 600");
                     // LX 700 (433MHz)
                     else if (cpu->freq >= 420 && cpu->freq <= 450)
-                        snprintf(tmp, NAME_LEN, "AMD Geode LX 700");
+                        snprintf(cpu->name, NAME_LEN, "AMD Geode LX 700");
                     // LX 800 (500MHz)
                     else if (cpu->freq >= 480 && cpu->freq <= 520)
-                        snprintf(tmp, NAME_LEN, "AMD Geode LX 800");
+                        snprintf(cpu->name, NAME_LEN, "AMD Geode LX 800");
                     // LX 900 (600MHz)
                     else if (cpu->freq >= 580 && cpu->freq <= 620)
-                        snprintf(tmp, NAME_LEN, "AMD Geode LX 900");
+                        snprintf(cpu->name, NAME_LEN, "AMD Geode LX 900");
                     // Generic fallback
                     else
-                        snprintf(tmp, NAME_LEN, "AMD Geode LX");
-                    free(cpu->name);
-                    cpu->name = tmp;
-                }
-                // If we have a supposed K6-III, it may actually be a K6-2+
-                // or K6-III+, and we may be able to tell from the stepping
-                else if (cpu->model == 13)
-                {
-                    if (cpu->stepping == 0)
-                    {
-                        char *tmp = malloc(NAME_LEN);
-                        snprintf(tmp, NAME_LEN, "AMD K6-III+");
-                        free(cpu->name);
-                        cpu->name = tmp;
-                    }
-                    else if (cpu->stepping == 4)
-                    {
-                        char *tmp = malloc(NAME_LEN);
-                        snprintf(tmp, NAME_LEN, "AMD K6-2+");
-                        free(cpu->name);
-                        cpu->name = tmp;
-                    }
-                }
-            }
-            else if (cpu->vendor[0] == 'I' && cpu->vendor[1] == 'n')
-            {
-                // Pentium OverDrives for Sockets 4 and 5 do not distinguish
-                // themselves by name from their base P5 or P54C Pentiums,
-                // but we can use OverDrive's 100+MHz clockspeeds to tell
-                // them apart
-                if (cpu->model == 1 && cpu->freq >= 100)
-                {
-                    char *tmp = malloc(NAME_LEN);
-                    snprintf(tmp, NAME_LEN, "Intel Pentium OverDrive (P5)");
-                    free(cpu->name);
-                    cpu->name = tmp;
-                }
-                else if (cpu->model == 2 && cpu->freq >= 100)
-                {
-                    char *tmp = malloc(NAME_LEN);
-                    snprintf(tmp, NAME_LEN,
-                        "Intel Pentium OverDrive (P54C)");
-                    free(cpu->name);
-                    cpu->name = tmp;
-                }
-                // The Pentium OverDrive for Socket 3 is guaranteed to be
-                // P54C, so let's report that to distinguish it from P5
-                // OverDrives for Socket 4
-                else if (cpu->model == 3 && cpu->freq < 84)
-                {
-                    char *tmp = malloc(NAME_LEN);
-                    snprintf(tmp, NAME_LEN,
-                        "Intel Pentium OverDrive (P54C)");
-                    free(cpu->name);
-                    cpu->name = tmp;
-                }
-            }
-            else if (cpu->vendor[0] == 'C' && cpu->vendor[1] == 'e')
-            {
-                // If we have a supposed WinChip 2-3D, we may be able to
-                // tell if its a WinChip 2A from the stepping
-                if (cpu->model == 8 && cpu->stepping == 7)
-                {
-                    char *tmp = malloc(NAME_LEN);
-                    snprintf(tmp, NAME_LEN, "IDT WinChip 2A");
-                    free(cpu->name);
-                    cpu->name = tmp;
+                        snprintf(cpu->name, NAME_LEN, "AMD Geode LX");
                 }
             }
         }
         // Pentium/P6 & K7
         else if (cpu->family == 6)
         {
-            if (cpu->vendor[0] == 'A')
+            if (vendor == X86_VENDOR_AMD)
             {
                 // AMD Mobile Athlon and Duron have the "mobile" part of their
                 // name before "AMD" *and* is not capitalised
                 if (strstr(cpu->name, "mobile AMD"))
                 {
-                    char *tmp = findReplace(cpu->name, NAME_LEN, "mobile AMD", "AMD Mobile");
-                    if (tmp)
-                    {
-                        free(cpu->name);
-                        cpu->name = tmp;
-                    }
+                    findReplaceIn(cpu->name, NAME_LEN, "mobile AMD", "AMD Mobile");
                 }
 
                 if (cpu->model == 3)
@@ -1710,12 +1798,7 @@ char *interpretCPU(CPU_DATA *cpu)
                     // assembled their name incorrectly
                     if (strstr(cpu->name, "Athlon"))
                     {
-                        char *tmp = findReplace(cpu->name, NAME_LEN, "Athlon", "Duron");
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
+                        findReplaceIn(cpu->name, NAME_LEN, "Athlon", "Duron");
                     }
                 }
 
@@ -1729,59 +1812,36 @@ char *interpretCPU(CPU_DATA *cpu)
                     // present.
                     if (strstr(cpu->name, "Athlon") && !strstr(cpu->name, " MP ") && !strstr(cpu->name, " XP "))
                     {
-                        int hasMPFlag = hasFlag(cpu, "mp");
-                        char *tmp = NULL;
+                        int hasMPFlag = hasFlag(cpu, CPU_FLAG_MP);
 
                         // Literally checking for multiple CPUs counted is the
                         // only sure way to figure this out for all possible
                         // models
                         if (cpu->index > 1)
-                            tmp = findReplace(cpu->name, NAME_LEN, "Athlon", "Athlon MP");
+                            findReplaceIn(cpu->name, NAME_LEN, "Athlon", "Athlon MP");
                         // Palomino XP and MP always receive the "mp" flag, so
                         // sans multiple CPUs counted, there is no reliable way
                         // to tell XP and MP apart
                         else if (cpu->model == 6)
-                            tmp = findReplace(cpu->name, NAME_LEN, "Athlon", "Athlon XP/MP");
+                            findReplaceIn(cpu->name, NAME_LEN, "Athlon", "Athlon XP/MP");
                         // Thoroughbred and Barton will be given the "mp" flag
                         // appropriately, so we can use that!
                         else if (cpu->model == 8 || cpu->model == 10)
                         {
                             if (hasMPFlag)
-                                tmp = findReplace(cpu->name, NAME_LEN, "Athlon", "Athlon MP");
+                                findReplaceIn(cpu->name, NAME_LEN, "Athlon", "Athlon MP");
                             else
-                                tmp = findReplace(cpu->name, NAME_LEN, "Athlon", "Athlon XP");
-                        }
-
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
+                                findReplaceIn(cpu->name, NAME_LEN, "Athlon", "Athlon XP");
                         }
                     }
-
-                    // All Athlon MPs were single core, so if the processor
-                    // index is higher than 1, we are definitely dealing with a
-                    // multi-CPU config and should set the core/thread count to
-                    // 1 to correctly flag this instead of 'having' two cores
-                    // for later
-                    if (cpu->index > 1 && cpu->cores == -1 && cpu->threads == -1)
-                        cpu->cores = cpu->threads = 1;
                 }
 
-                // There are multiple generations of K7-era Athlon and Duron
-                // that can reuse model numbers or lack them completely, so we
-                // should always append the core names to them
-                // See: Athlon K7750MTR52B A (6-2-2), Athlon K7850MPR52B A
-                //      (6-2-1), Athlon K7100MNR53B A (6-2-2)
-                // Argon: Athlon "Classic"
-                if (cpu->model == 1)
-                    strncat(cpu->name, " (Argon)", NAME_LEN - strlen(cpu->name) - 1);
-                // Pluto/Orion: Athlon "Classic"
-                else if (cpu->model == 2)
+                // Pluto and Orion (Athlon "Classic") are both model 2 and
+                // could have stepping 1 or 2, but we at least know Orion is
+                // 900MHz and higher. The other K7 core names are added by
+                // CPU_RULES.
+                if (cpu->model == 2)
                 {
-                    // Pluto and Orion are both model 2 and could have stepping
-                    // 1 or 2, but we at least know Orion is 900MHz and
-                    // higher...
                     if (cpu->freq > 0 && cpu->freq < 855)
                         strncat(cpu->name, " (Pluto)", NAME_LEN - strlen(cpu->name) - 1);
                     else if (cpu->freq > 895)
@@ -1789,81 +1849,11 @@ char *interpretCPU(CPU_DATA *cpu)
                     else
                         strncat(cpu->name, " (Pluto/Orion)", NAME_LEN - strlen(cpu->name) - 1);
                 }
-                // Spitfire: Duron
-                else if (cpu->model == 3)
-                    strncat(cpu->name, " (Spitfire)", NAME_LEN - strlen(cpu->name) - 1);
-                // Thunderbird: Athlon "Classic"
-                else if (cpu->model == 4)
-                    strncat(cpu->name, " (Thunderbird)", NAME_LEN - strlen(cpu->name) - 1);
-                // Palomino: Athlon XP/MP
-                else if (cpu->model == 6)
-                    strncat(cpu->name, " (Palomino)", NAME_LEN - strlen(cpu->name) - 1);
-                // Morgan: Duron
-                else if (cpu->model == 7)
-                    strncat(cpu->name, " (Morgan)", NAME_LEN - strlen(cpu->name) - 1);
-                // Thoroughbred: Athlon XP/MP
-                else if (cpu->model == 8)
-                    strncat(cpu->name, " (Thoroughbred)", NAME_LEN - strlen(cpu->name) - 1);
-                // Barton: Athlon XP/MP
-                else if (cpu->model == 10)
-                    strncat(cpu->name, " (Barton)", NAME_LEN - strlen(cpu->name) - 1);
             }
-            else if (cpu->vendor[0] == 'I' && cpu->vendor[1] == 'n')
+            else if (vendor == X86_VENDOR_INTEL)
             {
-                // If missing, we set the core/thread count to 1 for Dothan
-                // or older to ensure multi-CPU detection works
-                if (cpu->model <= 13 && cpu->cores == -1 &&
-                    cpu->threads == -1)
-                    cpu->cores = cpu->threads = 1;
-
-                // Klamath & Deschutes (OverDrive)
-                if (cpu->model == 3)
-                {
-                    // Pentium II OverDrive is actually a Deschutes core
-                    // despite reporting the same model as Klamath
-                    if (cpu->stepping == 2)
-                    {
-                        char *tmp = malloc(NAME_LEN);
-                        snprintf(tmp, NAME_LEN,
-                            "Intel Pentium II OverDrive (Deschutes)");
-                        free(cpu->name);
-                        cpu->name = tmp;
-                    }
-                }
-                // Deschutes (non-OverDrive) & Covington
-                else if (cpu->model == 5)
-                {
-                    // Pentium II (Deschutes) and the Deschutes-based
-                    // Pentium II Xeon and Celeron (Covington) have
-                    // basically the same CPU ID, but we can tell *some*
-                    // apart from the cache size. For sure: 32KB = Celeron;
-                    // 512KB = Pentium II; 1024/2048KB = Pentium II Xeon.
-                    // The 512KB Xeon cannot presently be distinguished,
-                    // though...
-                    if (cpu->cacheSize == 32)
-                    {
-                        char *tmp = malloc(NAME_LEN);
-                        snprintf(tmp, NAME_LEN,
-                            "Intel Celeron (Covington)");
-                        free(cpu->name);
-                        cpu->name = tmp;
-                    }
-                    else if (cpu->cacheSize == 512)
-                    {
-                        // Don't need to do anything, yet... At some point,
-                        // we will try to distinguish standard II and II
-                        // Xeon at this cache amount
-                    }
-                    else if (cpu->cacheSize >= 1024)
-                    {
-                        char *tmp = malloc(NAME_LEN);
-                        snprintf(tmp, NAME_LEN, "Intel Pentium II Xeon");
-                        free(cpu->name);
-                        cpu->name = tmp;
-                    }
-                }
                 // Banias
-                else if (cpu->model == 9)
+                if (cpu->model == 9)
                 {
                     // Both generations of Pentium M and related Celeron M
                     // do not distinguish themselves in their model names
@@ -1871,13 +1861,8 @@ char *interpretCPU(CPU_DATA *cpu)
                     // gen's name to distinguish it from second-gen Dothan
                     if (strstr(cpu->name, "(R) M p"))
                     {
-                        char *tmp = findReplace(cpu->name, NAME_LEN,
+                        findReplaceIn(cpu->name, NAME_LEN,
                             "M processor", "M (Banias)");
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
                     }
                 }
                 // Tualatin
@@ -1887,13 +1872,8 @@ char *interpretCPU(CPU_DATA *cpu)
                     // differentiate it from other IIIs
                     if (!strstr(cpu->name, "Tualatin"))
                     {
-                        char *tmp = findReplace(cpu->name, NAME_LEN, "III",
+                        findReplaceIn(cpu->name, NAME_LEN, "III",
                             "III (Tualatin)");
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
                     }
 
                     // If the cache size is 512KB, this is actually a
@@ -1901,13 +1881,7 @@ char *interpretCPU(CPU_DATA *cpu)
                     if (cpu->cacheSize == 512 &&
                         !strstr(cpu->name, "III-S"))
                     {
-                        char *tmp = findReplace(cpu->name, NAME_LEN, "III",
-                            "III-S");
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
+                        findReplaceIn(cpu->name, NAME_LEN, "III", "III-S");
                     }
                 }
                 // Dothan
@@ -1919,13 +1893,8 @@ char *interpretCPU(CPU_DATA *cpu)
                     // gen's name to distinguish it from first-gen Banias
                     if (strstr(cpu->name, "(R) M p"))
                     {
-                        char *tmp = findReplace(cpu->name, NAME_LEN,
+                        findReplaceIn(cpu->name, NAME_LEN,
                             "M processor", "M (Dothan)");
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
                     }
                 }
                 // Yonah
@@ -1938,19 +1907,12 @@ char *interpretCPU(CPU_DATA *cpu)
                     if (cpu->stepping == 8 &&
                         strstr(cpu->name, "Intel(R) CPU"))
                     {
-                        char *tmp = NULL;
                         if (cpu->cores == 1 || cpu->index == 1)
-                            tmp = findReplace(cpu->name, NAME_LEN,
+                            findReplaceIn(cpu->name, NAME_LEN,
                                 "CPU           ", "Core Solo ");
                         else if (cpu->cores == 2 || cpu->index == 2)
-                            tmp = findReplace(cpu->name, NAME_LEN,
+                            findReplaceIn(cpu->name, NAME_LEN,
                             "CPU           ", "Core Duo ");
-
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
                     }
                     // Some Yonah-based Celeron Ms only report as simply
                     // "Celeron", so we will add the "M" in if so
@@ -1958,13 +1920,8 @@ char *interpretCPU(CPU_DATA *cpu)
                     else if (cpu->stepping == 8 &&
                         strstr(cpu->name, "Celeron(R) CPU"))
                     {
-                        char *tmp = findReplace(cpu->name, NAME_LEN,
+                        findReplaceIn(cpu->name, NAME_LEN,
                             "Celeron(R) CPU", "Celeron M");
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
                     }
                 }
                 // Merom and Allendale
@@ -1978,26 +1935,16 @@ char *interpretCPU(CPU_DATA *cpu)
                         // See: Pentium T3200
                         if (strstr(cpu->name, "Dual  CPU"))
                         {
-                            char *tmp = findReplace(cpu->name, NAME_LEN,
+                            findReplaceIn(cpu->name, NAME_LEN,
                                 "Dual  CPU", " ");
-                            if (tmp)
-                            {
-                                free(cpu->name);
-                                cpu->name = tmp;
-                            }
                         }
                         // Mobile Core 2 Duo (Merom) may not have "Duo" in
                         // their name, so we will try to add it in
                         // See: Core 2 Duo T7400
                         else if (strstr(cpu->name, "2 CPU"))
                         {
-                            char *tmp = findReplace(cpu->name, NAME_LEN,
+                            findReplaceIn(cpu->name, NAME_LEN,
                                 "CPU         ", "Duo ");
-                            if (tmp)
-                            {
-                                free(cpu->name);
-                                cpu->name = tmp;
-                            }
                         }
 
                         // Allendale-based Core 2 Duo E4xxx and E6xxx may
@@ -2008,13 +1955,8 @@ char *interpretCPU(CPU_DATA *cpu)
                             if (strstr(cpu->name, "Duo  4") ||
                             strstr(cpu->name, "Duo  6"))
                             {
-                                char *tmp = findReplace(cpu->name, NAME_LEN,
+                                findReplaceIn(cpu->name, NAME_LEN,
                                     "Duo  ", "Duo E");
-                                if (tmp)
-                                {
-                                    free(cpu->name);
-                                    cpu->name = tmp;
-                                }
                             }
                         }
                     }
@@ -2030,25 +1972,14 @@ char *interpretCPU(CPU_DATA *cpu)
                         // See: Pentium SU2700, Pentium SU4100
                         if (strstr(cpu->name, "Intel(R) CPU           U"))
                         {
-                            char *tmp = findReplace(cpu->name, NAME_LEN,
+                            findReplaceIn(cpu->name, NAME_LEN,
                                 "(R) CPU           ", " Pentium S");
-                            if (tmp)
-                            {
-                                free(cpu->name);
-                                cpu->name = tmp;
-                            }
                         }
                         // LV Core 2 Duo lacks the "S" in their model number
                         // See: Core 2 Duo SL9600
                         else if (strstr(cpu->name, "Duo CPU     L"))
                         {
-                            char *tmp = findReplace(cpu->name, NAME_LEN,
-                                "CPU     ", "S");
-                            if (tmp)
-                            {
-                                free(cpu->name);
-                                cpu->name = tmp;
-                            }
+                            findReplaceIn(cpu->name, NAME_LEN, "CPU     ", "S");
                         }
                     }
                 }
@@ -2090,13 +2021,7 @@ char *interpretCPU(CPU_DATA *cpu)
                             char search[32];
                             snprintf(search, 32, " CPU       %c ",
                                 suffix[0]);
-                            char *tmp = findReplace(cpu->name, NAME_LEN,
-                                search, "-");
-                            if (tmp)
-                            {
-                                free(cpu->name);
-                                cpu->name = tmp;
-                            }
+                            findReplaceIn(cpu->name, NAME_LEN, search, "-");
 
                             // Add the correct suffix and discard the clock
                             // speed whilst we're at it
@@ -2114,13 +2039,8 @@ char *interpretCPU(CPU_DATA *cpu)
                         else if (strstr(cpu->name, ") i") &&
                             strstr(cpu->name, " CPU         "))
                         {
-                            char *tmp = findReplace(cpu->name, NAME_LEN,
+                            findReplaceIn(cpu->name, NAME_LEN,
                                 " CPU         ", "-");
-                            if (tmp)
-                            {
-                                free(cpu->name);
-                                cpu->name = tmp;
-                            }
                         }
                     }
 
@@ -2151,13 +2071,7 @@ char *interpretCPU(CPU_DATA *cpu)
                         // See: Xeon E3-1230, Xeon E3-1275
                         if (strstr(cpu->name, "E31"))
                         {
-                            char *tmp = findReplace(cpu->name, NAME_LEN,
-                                "E31", " E3-1");
-                            if (tmp)
-                            {
-                                free(cpu->name);
-                                cpu->name = tmp;
-                            }
+                            findReplaceIn(cpu->name, NAME_LEN, "E31", " E3-1");
                         }
                     }
                 }
@@ -2169,13 +2083,7 @@ char *interpretCPU(CPU_DATA *cpu)
                     // See: Xeon E5-2690 (original/v1)
                     if (strstr(cpu->name, " 0 @"))
                     {
-                        char *tmp = findReplace(cpu->name, NAME_LEN,
-                            " 0 ", " ");
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
+                        findReplaceIn(cpu->name, NAME_LEN, " 0 ", " ");
                     }
                 }
                 // Westmere EX
@@ -2186,13 +2094,7 @@ char *interpretCPU(CPU_DATA *cpu)
                     // See: Xeon E7-4820 (original/v1)
                     if (strstr(cpu->name, "- "))
                     {
-                        char *tmp = findReplace(cpu->name, NAME_LEN, "- ",
-                            "-");
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
+                        findReplaceIn(cpu->name, NAME_LEN, "- ", "-");
                     }
                 }
                 // Ivy Bridge
@@ -2212,10 +2114,8 @@ char *interpretCPU(CPU_DATA *cpu)
                     // has a non-descriptive name like "Intel 4000", thus we
                     // discard it and create a new model name
                     if (cpu->stepping == 8 && cpu->freq == 500)
-                    {
-                        free(cpu->name);
-                        cpu->name = strdup("Intel Atom Z34xx (Edison)");
-                    }
+                        snprintf(cpu->name, NAME_LEN,
+                            "Intel Atom Z34xx (Edison)");
                 }
 
                 // There are some examples of Intel Core processors with
@@ -2252,54 +2152,35 @@ char *interpretCPU(CPU_DATA *cpu)
             // instead
             if (!strstr(cpu->name, "Xeon"))
             {
-                free(cpu->name);
                 // Knights Ferry
                 if (cpu->model == 0)
-                    cpu->name = strdup("Intel Xeon Phi (Knights Ferry)");
+                    snprintf(cpu->name, NAME_LEN,
+                        "Intel Xeon Phi (Knights Ferry)");
                 // Knights Corner
                 // See: Xeon Phi 7110P
                 else if (cpu->model == 1)
-                    cpu->name = strdup("Intel Xeon Phi (Knights Corner)");
+                    snprintf(cpu->name, NAME_LEN,
+                        "Intel Xeon Phi (Knights Corner)");
                 // Fallback
                 else
-                    cpu->name = strdup("Intel Xeon Phi");
+                    snprintf(cpu->name, NAME_LEN, "Intel Xeon Phi");
             }
         }
         // NetBurst & K8
         else if (cpu->family == 15)
         {
-            if (cpu->vendor[0] == 'A')
+            if (vendor == X86_VENDOR_AMD)
             {
-                // SledgeHammer (5), Athens/Troy (37), San Diego (39)
-                if (cpu->model == 5 || cpu->model == 37 || cpu->model == 39)
-                {
-                    // Some entire models of K8-based Opterons were always
-                    // single core, so if the processor index is higher than
-                    // 1, we are definitely dealing with a multi-CPU config
-                    // and should set the core/thread count to 1 to
-                    // correctly flag this instead of 'having' two cores for
-                    // later
-                    // See: Opteron 148 (E4), Opteron 246 (CG),
-                    //      Opteron 246 (E4), Opteron 848 (E4)
-                    if (cpu->index > 1 && cpu->cores == -1 &&
-                        cpu->threads == -1)
-                        cpu->cores = cpu->threads = 1;
-                }
                 // Brisbane
-                else if (cpu->model == 107)
+                if (cpu->model == 107)
                 {
                     // Some Athlon 64 X2s do not report "X2" in their model
                     // name
                     // See: Athlon 64 X2 5000+
                     if (strstr(cpu->name, "64 Dual Core"))
                     {
-                        char *tmp = findReplace(cpu->name, NAME_LEN,
+                        findReplaceIn(cpu->name, NAME_LEN,
                             "64 Dual Core", "64 X2");
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
                     }
                 }
 
@@ -2307,16 +2188,11 @@ char *interpretCPU(CPU_DATA *cpu)
                 // before "AMD"
                 if (strstr(cpu->name, "Mobile AMD Sempron"))
                 {
-                    char *tmp = findReplace(cpu->name, NAME_LEN,
+                    findReplaceIn(cpu->name, NAME_LEN,
                         "Mobile AMD Sempron", "AMD Mobile Sempron");
-                    if (tmp)
-                    {
-                        free(cpu->name);
-                        cpu->name = tmp;
-                    }
                 }
             }
-            else if (cpu->vendor[0] == 'I' && cpu->vendor[1] == 'n')
+            else if (vendor == X86_VENDOR_INTEL)
             {
                 // Early Pentium 4s generally don't have a model number, and
                 // the later ones that do *don't* report it, so we will
@@ -2324,32 +2200,25 @@ char *interpretCPU(CPU_DATA *cpu)
                 if (strstr(cpu->name, "Pentium(R) 4") ||
                     strstr(cpu->name, "Celeron"))
                 {
-                    char *tmp = NULL;
                     // Willamette
                     if (cpu->model == 0 || cpu->model == 1)
-                        tmp = findReplace(cpu->name, NAME_LEN, "CPU",
+                        findReplaceIn(cpu->name, NAME_LEN, "CPU",
                             " (Willamette)");
                     // Northwood
                     else if (cpu->model == 2)
-                        tmp = findReplace(cpu->name, NAME_LEN, "CPU",
+                        findReplaceIn(cpu->name, NAME_LEN, "CPU",
                             " (Northwood)");
                     // Prescott
                     // See: B80546PE0561M, RK80546PG0881M, RK80546PG0961M
                     else if (cpu->model == 3 || cpu->model == 4)
-                        tmp = findReplace(cpu->name, NAME_LEN, "CPU",
+                        findReplaceIn(cpu->name, NAME_LEN, "CPU",
                             " (Prescott)");
                     // Cedar Mill
                     // See: Pentium 4 631 (5), Pentium 4 641 (2),
                     //      Pentium 4 651 (4)
                     else if (cpu->model == 6)
-                        tmp = findReplace(cpu->name, NAME_LEN, "CPU",
+                        findReplaceIn(cpu->name, NAME_LEN, "CPU",
                             " (Cedar Mill)");
-
-                    if (tmp)
-                    {
-                        free(cpu->name);
-                        cpu->name = tmp;
-                    }
                 }
                 // Ditto for non-Extreme Pentium D
                 else if (!strstr(cpu->name, ") X") && cpu->cores == 2 &&
@@ -2358,24 +2227,17 @@ char *interpretCPU(CPU_DATA *cpu)
                     // Non-Extreme (no Hyper-Threading)
                     if (cpu->cores == cpu->threads)
                     {
-                        char *tmp = NULL;
                         // Smithfield
                         // See: Pentium D 805 (7), Pentium D 830 (4)
                         if (cpu->model == 4)
-                            tmp = findReplace(cpu->name, NAME_LEN, "D CPU",
+                            findReplaceIn(cpu->name, NAME_LEN, "D CPU",
                                 "D (Smithfield)");
                         // Presler
                         // See: Pentium D 920 (2), Pentium D 945 (5),
                         //      Pentium D 960 (4)
                         else if (cpu->model == 6)
-                            tmp = findReplace(cpu->name, NAME_LEN, "D CPU",
+                            findReplaceIn(cpu->name, NAME_LEN, "D CPU",
                                 "D (Presler)");
-
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
                     }
                     // There are so few 2C/4T Pentium Extreme Editions
                     // (really Pentium D with Hyper-Threading) and all with
@@ -2385,40 +2247,31 @@ char *interpretCPU(CPU_DATA *cpu)
                     //      Pentium Extreme 965
                     else if (cpu->cores == 2 && cpu->threads == 4)
                     {
-                        char *tmp = NULL;
                         if (cpu->model == 4 &&
                             strstr(cpu->name, "3.2"))
-                            tmp = findReplace(cpu->name, NAME_LEN, "D CPU",
+                            findReplaceIn(cpu->name, NAME_LEN, "D CPU",
                                 "Extreme 840");
                         else if (cpu->model == 6 &&
                             strstr(cpu->name, "3.4"))
-                            tmp = findReplace(cpu->name, NAME_LEN, "CPU",
+                            findReplaceIn(cpu->name, NAME_LEN, "CPU",
                                 "Pentium Extreme 955");
                         else if (cpu->model == 6 &&
                             strstr(cpu->name, "3.7"))
-                            tmp = findReplace(cpu->name, NAME_LEN, "D CPU",
+                            findReplaceIn(cpu->name, NAME_LEN, "D CPU",
                                 "Extreme 965");
-
-                        if (tmp)
-                        {
-                            free(cpu->name);
-                            cpu->name = tmp;
-                        }
                     }
                 }
                 // Ditto for Xeon
                 else
                 {
-                    char *tmp = NULL;
+                    // Core name to replace "CPU" with
+                    const char *core = NULL;
 
                     // For Xeons that don't call themselves Xeon...
                     if (strstr(cpu->name, "Intel(R) CPU"))
                     {
-                        tmp = findReplace(cpu->name, NAME_LEN,
-                            "Intel(R) CPU", "Intel Xeon CPU");
-                        free(cpu->name);
-                        cpu->name = tmp;
-                        tmp = NULL;
+                        findReplaceIn(cpu->name, NAME_LEN, "Intel(R) CPU",
+                            "Intel Xeon CPU");
                     }
 
                     // For Xeons that call themselves "XEON"...
@@ -2439,8 +2292,7 @@ char *interpretCPU(CPU_DATA *cpu)
                         if (cpu->cores == -1 || cpu->threads == -1)
                             cpu->cores = cpu->threads = 1;
 
-                        tmp = findReplace(cpu->name, NAME_LEN, "CPU",
-                            "(Foster)");
+                        core = "(Foster)";
                     }
                     // Foster & Foster MP
                     else if (cpu->model == 1)
@@ -2456,8 +2308,7 @@ char *interpretCPU(CPU_DATA *cpu)
                         if (cpu->threads == 2 || cpu->index > 2 ||
                             cpu->physIDs.maxPhysID > 2)
                         {
-                            tmp = findReplace(cpu->name, NAME_LEN, "CPU",
-                                "(Foster MP)");
+                            core = "(Foster MP)";
                             // If the processor index count is higher than
                             // 8, we must have HT enabled, so we can set a
                             // sure thread value if needed
@@ -2469,8 +2320,7 @@ char *interpretCPU(CPU_DATA *cpu)
                         // dealing with a Foster DP
                         else if (cpu->freq > 1650)
                         {
-                            tmp = findReplace(cpu->name, NAME_LEN, "CPU",
-                                "(Foster)");
+                            core = "(Foster)";
                             // If for some reason we don't have core/thread
                             // info, we know for sure that Foster is always
                             // 1C/1T despite exposing the "ht" flag
@@ -2479,9 +2329,8 @@ char *interpretCPU(CPU_DATA *cpu)
                         }
 
                         // Generic fallback
-                        if (!tmp)
-                            tmp = findReplace(cpu->name, NAME_LEN, "CPU",
-                                "(Foster)");
+                        if (!core)
+                            core = "(Foster)";
                     }
                     // Prestonia, Gallatin or Gallatin MP
                     else if (cpu->model == 2)
@@ -2496,8 +2345,7 @@ char *interpretCPU(CPU_DATA *cpu)
                         // respectively
                         if (cpu->index > 4 || cpu->physIDs.maxPhysID > 2)
                         {
-                            tmp = findReplace(cpu->name, NAME_LEN, "CPU",
-                                "(Gallatin MP)");
+                            core = "(Gallatin MP)";
                             // If the processor index count is higher than
                             // 8, we must have HT enabled, so we can set a
                             // sure thread value if needed
@@ -2506,14 +2354,12 @@ char *interpretCPU(CPU_DATA *cpu)
                         }
 
                         // Generic fallback
-                        if (!tmp)
-                            tmp = findReplace(cpu->name, NAME_LEN, "CPU",
-                                "(Prestonia/Gallatin)");
+                        if (!core)
+                            core = "(Prestonia/Gallatin)";
                     }
                     // Nocona
                     else if (cpu->model == 3)
-                        tmp = findReplace(cpu->name, NAME_LEN, "CPU",
-                            "(Nocona)");
+                        core = "(Nocona)";
                     // Cranford, Irwindale, Paxville DP or Paxville
                     else if (cpu->model == 4)
                     {
@@ -2524,8 +2370,7 @@ char *interpretCPU(CPU_DATA *cpu)
                             // 3.66GHz
                             if (strstr(cpu->name, "3.16GHz") ||
                                 strstr(cpu->name, "3.66GHz"))
-                                tmp = findReplace(cpu->name, NAME_LEN,
-                                    "CPU", "(Cranford)");
+                                core = "(Cranford)";
                         }
                         // Paxville DP or Paxville
                         else if (cpu->stepping == 8)
@@ -2533,17 +2378,14 @@ char *interpretCPU(CPU_DATA *cpu)
                             // Paxville DP only came as 2.8GHz and no MP has
                             // the same speed
                             if (strstr(cpu->name, "2.80GHz"))
-                                tmp = findReplace(cpu->name, NAME_LEN,
-                                    "CPU", "(Paxville DP)");
+                                core = "(Paxville DP)";
                             else
-                                tmp = findReplace(cpu->name, NAME_LEN,
-                                    "CPU", "(Paxville)");
+                                core = "(Paxville)";
                         }
 
                         // Generic fallback
-                        if (!tmp)
-                            tmp = findReplace(cpu->name, NAME_LEN, "CPU",
-                                "(Cranford/Irwindale/Paxville)");
+                        if (!core)
+                            core = "(Cranford/Irwindale/Paxville)";
                     }
                     // Dempsey or Tulsa
                     else if (cpu->model == 6)
@@ -2551,19 +2393,14 @@ char *interpretCPU(CPU_DATA *cpu)
                         // If there is more than 2048KB cache, this must be
                         // a Tusla
                         if (cpu->cacheSize > 2048)
-                            tmp = findReplace(cpu->name, NAME_LEN, "CPU",
-                                "(Tulsa)");
+                            core = "(Tulsa)";
                         // Generic fallback
                         else
-                            tmp = findReplace(cpu->name, NAME_LEN, "CPU",
-                                "(Dempsey/Tulsa)");
+                            core = "(Dempsey/Tulsa)";
                     }
 
-                    if (tmp)
-                    {
-                        free(cpu->name);
-                        cpu->name = tmp;
-                    }
+                    if (core)
+                        findReplaceIn(cpu->name, NAME_LEN, "CPU", core);
                 }
             }
         }
@@ -2727,3 +2564,47 @@ char *interpretCPU(CPU_DATA *cpu)
 
     return result;
 }
+
+/**
+ * Builds an ISA level string (e.g. "x86-64-v3 (AVX2)") from given CPU data's
+ * flags. CPUs that are not x86-64 are given their highest SIMD tier instead.
+ * @param cpu A pointer to a CPU_DATA struct containing the flags to check
+ * @return String containing the ISA level; NULL if not x86 or unknown
+ */
+char *interpretISA(const CPU_DATA *cpu)
+{
+    if (cpu->arch != X86)
+        return NULL;
+
+    const char *tier = NULL;
+    for (int i = SIMD_TIERS_LEN - 1; i >= 0 && !tier; i--)
+        if (hasFlag(cpu, SIMD_TIERS[i].flag))
+            tier = SIMD_TIERS[i].name;
+    int level = getISALevel(cpu);
+
+    // x86-64 CPUs meeting no higher level are just "x86-64", like -march
+    char name[24] = "x86-64";
+    if (level > 1)
+        snprintf(name, sizeof(name), "x86-64-v%d", level);
+
+    char result[32];
+    if (level > 0 && (COMPACT || !tier))
+        snprintf(result, sizeof(result), "%s", name);
+    else if (level > 0)
+        snprintf(result, sizeof(result), "%s (%s)", name, tier);
+    else if (tier)
+        snprintf(result, sizeof(result), "%s", tier);
+    else
+        return NULL;
+    return strdup(result);
+}
+
+/**
+ * Marks the given CPU flag as present.
+ * @param cpu CPU_DATA struct being filled in
+ * @param flag The flag to set (CPU_FLAG_HT, CPU_FLAG_PAE, etc.)
+ */
+void setFlag(CPU_DATA *cpu, const CPU_FLAG flag)
+{
+    cpu->flags[flag / 32] |= 1u << (flag % 32);
+}
@@ -15,17 +15,21 @@
 #ifndef CPU
 #define CPU
 
+#include "cpuflags.h"
+
 #include <stdio.h>
 
 
 
-// /proc/cpuinfo read buffer string length
-#define CPUINFO_BUFFER_LEN      4096
+// /proc/cpuinfo read block length (also the longest line read whole)
+#define CPUINFO_BLOCK_LEN       65536
+// Longest cpuinfo key (including its ':') whose fields are remembered
+#define CPUINFO_KEY_LEN         32
+// Number of different cpuinfo keys whose fields are remembered per read
+#define CPUINFO_KEYS_SIZE       64
 // Flag value for PHYS_IDS.noUniquePhysIDs when PHYS_IDS.uniquePhysIDs is
 // unreliable and should be ignored
 #define IGNORE_UNIQUE_PHYS_IDS  -1
-// CPU_DATA.flags string length
-#define FLAGS_LEN               1536
 // CPU_DATA.machine string length
 #define MACHINE_LEN             128
 // CPU_DATA.name string length
@@ -40,6 +44,10 @@
 #define UARCH_LEN               128
 // PHYS_IDS.uniquePhysIDs array size
 #define UNIQUE_PHYS_IDS_SIZE    128
+// sysfs CPU list (e.g. "0-3,8") read buffer string length
+#define CPU_LIST_LEN            4096
+// Highest number of CPUs sysfs topology is read for
+#define SYSFS_CPUS_MAX          8192
 // CPU_DATA.vendor string length
 #define VENDOR_LEN              16
 
@@ -77,6 +85,56 @@ typedef enum
 
 #endif
 
+// Fields read from cpuinfo, in the order a line is tried against them (a line
+// is taken by the first field it matches that has not been found yet)
+typedef enum
+{
+#ifndef X86_ONLY
+    CPUINFO_UARCH,
+#endif
+    CPUINFO_VENDOR_ID,
+#ifndef X86_ONLY
+    CPUINFO_IMPLEMENTER,
+#endif
+    CPUINFO_MODEL_NAME,
+#ifndef X86_ONLY
+    CPUINFO_ARCHITECTURE,
+#endif
+    CPUINFO_FAMILY,
+#ifndef X86_ONLY
+    CPUINFO_CPU_MODEL,
+    CPUINFO_REVISION_NO,
+    CPUINFO_M68K_CPU,
+    CPUINFO_POWER_CPU,
+    CPUINFO_ISA,
+#endif
+    CPUINFO_MODEL,
+    CPUINFO_STEPPING,
+    CPUINFO_MHZ,
+#ifndef X86_ONLY
+    CPUINFO_CLOCKING,
+    CPUINFO_CLOCK,
+    CPUINFO_FREQ,
+#endif
+    CPUINFO_PROCESSOR,
+    CPUINFO_PHYS_ID,
+    CPUINFO_CORES,
+    CPUINFO_SIBLINGS,
+#ifndef X86_ONLY
+    CPUINFO_HART,
+#endif
+    CPUINFO_CACHE_SIZE,
+    CPUINFO_FLAGS,
+    CPUINFO_ADDRESS_SIZES,
+#ifndef X86_ONLY
+    CPUINFO_PLATFORM,
+    CPUINFO_MACHINE,
+    CPUINFO_VENDOR,
+    CPUINFO_REVISION_STR,
+#endif
+    CPUINFO_FIELDS_LEN
+} CPUINFO_FIELD;
+
 
 
 // Datapoints for x86 physical ID
@@ -131,14 +189,49 @@ typedef struct {
     int threads;
     // Cache size in KB (x86)
     int cacheSize;
-    // CPU flags (x86)
-    char flags[FLAGS_LEN];
+    // Bit set of known CPU flags, indexed by CPU_FLAG (x86)
+    unsigned int flags[CPU_FLAG_WORDS];
+    // Space-separated CPU flags not in CPU_FLAGS_LIST; NULL if none (x86)
+    char *otherFlags;
     // Physical address size (x86)
     int physAddrSize;
     // Virtual address size (x86)
     int virtAddrSize;
 } CPU_DATA;
 
+// A key prefix that marks a cpuinfo line as a field
+typedef struct {
+    CPUINFO_FIELD field;
+    const char *prefix;
+    // Number of characters of the prefix that must match
+    int len;
+    int caseless;
+} CPUINFO_PREFIX;
+
+// A cpuinfo key and the fields its lines match, remembered so that each
+// different key is only matched against CPUINFO_PREFIXES once
+typedef struct {
+    unsigned int hash;
+    // Key including its ':' (if any); 0 if the slot is unused
+    int len;
+    char key[CPUINFO_KEY_LEN];
+    // Bit set of the CPUINFO_FIELDs matched
+    unsigned int fields;
+} CPUINFO_KEY;
+
+// A flag an x86-64 microarchitecture level (1-4) needs, on top of those of
+// the levels below it
+typedef struct {
+    int level;
+    CPU_FLAG flag;
+} X86_64_LEVEL_FLAG;
+
+// A SIMD extension tier and the flag that marks a CPU as having it
+typedef struct {
+    const char *name;
+    CPU_FLAG flag;
+} SIMD_TIER;
+
 // Maps a canonical/base CPU vendor name to an alias
 typedef struct {
     const char *canonical;
@@ -167,6 +260,109 @@ static const int GPU_FROM_CPU_NEEDLES_LEN = sizeof(GPU_FROM_CPU_NEEDLES) /
 
 #endif
 
+// Prefixes of the cpuinfo keys we read, across every supported architecture
+static const CPUINFO_PREFIX CPUINFO_PREFIXES[] = {
+#ifndef X86_ONLY
+    { CPUINFO_UARCH,            "uarch",                5,  1 },
+#endif
+    { CPUINFO_VENDOR_ID,        "vendor_id",            9,  1 },
+#ifndef X86_ONLY
+    { CPUINFO_IMPLEMENTER,      "cpu implementer",      15, 1 },
+    { CPUINFO_IMPLEMENTER,      "cpu implementor",      15, 1 },
+#endif
+    { CPUINFO_MODEL_NAME,       "model name",           10, 1 },
+#ifndef X86_ONLY
+    { CPUINFO_ARCHITECTURE,     "CPU architecture",     16, 1 },
+#endif
+    { CPUINFO_FAMILY,           "cpu family",           10, 1 },
+#ifndef X86_ONLY
+    { CPUINFO_CPU_MODEL,        "cpu model",            9,  1 },
+    { CPUINFO_REVISION_NO,      "CPU revision",         12, 1 },
+    { CPUINFO_M68K_CPU,         "CPU:",                 4,  0 },
+    { CPUINFO_POWER_CPU,        "cpu",                  3,  0 },
+    { CPUINFO_ISA,              "isa",                  3,  1 },
+#endif
+    { CPUINFO_MODEL,            "model",                5,  1 },
+    { CPUINFO_STEPPING,         "stepping",             8,  1 },
+    { CPUINFO_MHZ,              "cpu mhz",              7,  1 },
+#ifndef X86_ONLY
+    { CPUINFO_CLOCKING,         "clocking",             8,  1 },
+    { CPUINFO_CLOCK,            "clock",                5,  1 },
+    { CPUINFO_FREQ,             "cpu-freq",             8,  1 },
+#endif
+    { CPUINFO_PROCESSOR,        "processor",            9,  1 },
+    { CPUINFO_PHYS_ID,          "physical id",          11, 1 },
+    { CPUINFO_CORES,            "cpu cores",            9,  1 },
+    { CPUINFO_SIBLINGS,         "siblings",             8,  1 },
+    { CPUINFO_SIBLINGS,         "Number of siblings",   18, 1 },
+#ifndef X86_ONLY
+    { CPUINFO_HART,             "hart",                 4,  1 },
+#endif
+    { CPUINFO_CACHE_SIZE,       "cache size",           10, 1 },
+    { CPUINFO_FLAGS,            "flags",                5,  1 },
+    { CPUINFO_ADDRESS_SIZES,    "address sizes",        13, 1 },
+#ifndef X86_ONLY
+    { CPUINFO_PLATFORM,         "platform",             8,  1 },
+    { CPUINFO_MACHINE,          "machine",              7,  1 },
+    { CPUINFO_VENDOR,           "vendor",               6,  1 },
+    // Only the first 6 characters have ever been matched
+    { CPUINFO_REVISION_STR,     "revision",             6,  1 }
+#endif
+};
+static const int CPUINFO_PREFIXES_LEN = sizeof(CPUINFO_PREFIXES) /
+    sizeof(CPUINFO_PREFIXES[0]);
+
+// Flags needed by each x86-64 microarchitecture level, as psABI defines them
+static const X86_64_LEVEL_FLAG X86_64_LEVEL_FLAGS[] = {
+    { 1, CPU_FLAG_LM },
+    { 1, CPU_FLAG_CMOV },
+    { 1, CPU_FLAG_CX8 },
+    { 1, CPU_FLAG_FPU },
+    { 1, CPU_FLAG_FXSR },
+    { 1, CPU_FLAG_MMX },
+    { 1, CPU_FLAG_SYSCALL },
+    { 1, CPU_FLAG_SSE },
+    { 1, CPU_FLAG_SSE2 },
+    { 2, CPU_FLAG_CX16 },
+    { 2, CPU_FLAG_LAHF_LM },
+    { 2, CPU_FLAG_POPCNT },
+    { 2, CPU_FLAG_PNI },
+    { 2, CPU_FLAG_SSE4_1 },
+    { 2, CPU_FLAG_SSE4_2 },
+    { 2, CPU_FLAG_SSSE3 },
+    { 3, CPU_FLAG_AVX },
+    { 3, CPU_FLAG_AVX2 },
+    { 3, CPU_FLAG_BMI1 },
+    { 3, CPU_FLAG_BMI2 },
+    { 3, CPU_FLAG_F16C },
+    { 3, CPU_FLAG_FMA },
+    { 3, CPU_FLAG_ABM },
+    { 3, CPU_FLAG_MOVBE },
+    { 3, CPU_FLAG_XSAVE },
+    { 4, CPU_FLAG_AVX512F },
+    { 4, CPU_FLAG_AVX512BW },
+    { 4, CPU_FLAG_AVX512CD },
+    { 4, CPU_FLAG_AVX512DQ },
+    { 4, CPU_FLAG_AVX512VL }
+};
+static const int X86_64_LEVEL_FLAGS_LEN = sizeof(X86_64_LEVEL_FLAGS) /
+    sizeof(X86_64_LEVEL_FLAGS[0]);
+
+// SIMD extension tiers, from lowest to highest
+static const SIMD_TIER SIMD_TIERS[] = {
+    { "MMX",        CPU_FLAG_MMX },
+    { "SSE",        CPU_FLAG_SSE },
+    { "SSE2",       CPU_FLAG_SSE2 },
+    { "SSE3",       CPU_FLAG_PNI },
+    { "SSSE3",      CPU_FLAG_SSSE3 },
+    { "SSE4.1",     CPU_FLAG_SSE4_1 },
+    { "SSE4.2",     CPU_FLAG_SSE4_2 },
+    { "AVX",        CPU_FLAG_AVX },
+    { "AVX2",       CPU_FLAG_AVX2 },
+    { "AVX-512",    CPU_FLAG_AVX512F }
+};
+static const int SIMD_TIERS_LEN = sizeof(SIMD_TIERS) / sizeof(SIMD_TIERS[0]);
+
 // Known CPU vendor canonical-alias name mappings
 static const VENDOR_ALIAS VENDOR_ALIASES[] = {
     { "Intel",          "GenuineIntel" },
@@ -189,8 +385,13 @@ static const int VENDOR_ALIASES_LEN = sizeof(VENDOR_ALIASES) /
 
 
 char *cleanCPUName(const CPU_ARCH, const char*, int);
+void freeCPU(CPU_DATA*);
 CPU_DATA *getCPU(char*, char**);
-int hasFlag(const CPU_DATA*, const char*);
+CPU_FLAG findCPUFlag(const char*, const int);
+int getISALevel(const CPU_DATA*);
+int hasFlag(const CPU_DATA*, const CPU_FLAG);
 char *interpretCPU(CPU_DATA*);
+char *interpretISA(const CPU_DATA*);
+void setFlag(CPU_DATA*, const CPU_FLAG);
 
 #endif
@@ -0,0 +1,349 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Known x86 CPU flags, as named in cpuinfo         ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#ifndef CPUFLAGS
+#define CPUFLAGS
+
+
+
+// Every flag CPU_DATA.flags has a bit for, as X(ENUM_NAME, "cpuinfo name").
+// Must stay sorted by cpuinfo name (in strcmp order, so '_' comes before
+// letters), as names are found by binary search. Flags not listed here are
+// kept in CPU_DATA.otherFlags instead.
+#define CPU_FLAGS_LIST(X)                                               \
+    X(3DNOW,                 "3dnow")                                   \
+    X(3DNOWEXT,              "3dnowext")                                \
+    X(3DNOWPREFETCH,         "3dnowprefetch")                           \
+    X(ABM,                   "abm")                                     \
+    X(ACC_POWER,             "acc_power")                               \
+    X(ACE,                   "ace")                                     \
+    X(ACE2,                  "ace2")                                    \
+    X(ACE2_EN,               "ace2_en")                                 \
+    X(ACE_EN,                "ace_en")                                  \
+    X(ACPI,                  "acpi")                                    \
+    X(ADX,                   "adx")                                     \
+    X(AES,                   "aes")                                     \
+    X(AMD_DCM,               "amd_dcm")                                 \
+    X(AMD_IBPB,              "amd_ibpb")                                \
+    X(AMD_IBRS,              "amd_ibrs")                                \
+    X(AMD_PPIN,              "amd_ppin")                                \
+    X(AMD_SSBD,              "amd_ssbd")                                \
+    X(AMD_STIBP,             "amd_stibp")                               \
+    X(AMX_BF16,              "amx_bf16")                                \
+    X(AMX_FP16,              "amx_fp16")                                \
+    X(AMX_INT8,              "amx_int8")                                \
+    X(AMX_TILE,              "amx_tile")                                \
+    X(APERFMPERF,            "aperfmperf")                              \
+    X(APIC,                  "apic")                                    \
+    X(ARAT,                  "arat")                                    \
+    X(ARCH_CAPABILITIES,     "arch_capabilities")                       \
+    X(ARCH_LBR,              "arch_lbr")                                \
+    X(ARCH_PERFMON,          "arch_perfmon")                            \
+    X(ART,                   "art")                                     \
+    X(AVIC,                  "avic")                                    \
+    X(AVX,                   "avx")                                     \
+    X(AVX2,                  "avx2")                                    \
+    X(AVX512_4FMAPS,         "avx512_4fmaps")                           \
+    X(AVX512_4VNNIW,         "avx512_4vnniw")                           \
+    X(AVX512_BF16,           "avx512_bf16")                             \
+    X(AVX512_BITALG,         "avx512_bitalg")                           \
+    X(AVX512_FP16,           "avx512_fp16")                             \
+    X(AVX512_VBMI2,          "avx512_vbmi2")                            \
+    X(AVX512_VNNI,           "avx512_vnni")                             \
+    X(AVX512_VP2INTERSECT,   "avx512_vp2intersect")                     \
+    X(AVX512_VPOPCNTDQ,      "avx512_vpopcntdq")                        \
+    X(AVX512BW,              "avx512bw")                                \
+    X(AVX512CD,              "avx512cd")                                \
+    X(AVX512DQ,              "avx512dq")                                \
+    X(AVX512ER,              "avx512er")                                \
+    X(AVX512F,               "avx512f")                                 \
+    X(AVX512IFMA,            "avx512ifma")                              \
+    X(AVX512PF,              "avx512pf")                                \
+    X(AVX512VBMI,            "avx512vbmi")                              \
+    X(AVX512VL,              "avx512vl")                                \
+    X(AVX_IFMA,              "avx_ifma")                                \
+    X(AVX_NE_CONVERT,        "avx_ne_convert")                          \
+    X(AVX_VNNI,              "avx_vnni")                                \
+    X(AVX_VNNI_INT8,         "avx_vnni_int8")                           \
+    X(BMI1,                  "bmi1")                                    \
+    X(BMI2,                  "bmi2")                                    \
+    X(BPEXT,                 "bpext")                                   \
+    X(BTS,                   "bts")                                     \
+    X(BUS_LOCK_DETECT,       "bus_lock_detect")                         \
+    X(CAT_L2,                "cat_l2")                                  \
+    X(CAT_L3,                "cat_l3")                                  \
+    X(CDP_L3,                "cdp_l3")                                  \
+    X(CENTAUR_MCR,           "centaur_mcr")                             \
+    X(CID,                   "cid")                                     \
+    X(CLDEMOTE,              "cldemote")                                \
+    X(CLFLUSH,               "clflush")                                 \
+    X(CLFLUSHOPT,            "clflushopt")                              \
+    X(CLWB,                  "clwb")                                    \
+    X(CLZERO,                "clzero")                                  \
+    X(CMOV,                  "cmov")                                    \
+    X(CMP_LEGACY,            "cmp_legacy")                              \
+    X(CMPCCXADD,             "cmpccxadd")                               \
+    X(CONSTANT_TSC,          "constant_tsc")                            \
+    X(CORE_CAPABILITIES,     "core_capabilities")                       \
+    X(CPB,                   "cpb")                                     \
+    X(CPUID,                 "cpuid")                                   \
+    X(CPUID_FAULT,           "cpuid_fault")                             \
+    X(CQM,                   "cqm")                                     \
+    X(CQM_LLC,               "cqm_llc")                                 \
+    X(CQM_MBM_LOCAL,         "cqm_mbm_local")                           \
+    X(CQM_MBM_TOTAL,         "cqm_mbm_total")                           \
+    X(CQM_OCCUP_LLC,         "cqm_occup_llc")                           \
+    X(CR8_LEGACY,            "cr8_legacy")                              \
+    X(CX16,                  "cx16")                                    \
+    X(CX8,                   "cx8")                                     \
+    X(CXMMX,                 "cxmmx")                                   \
+    X(CYRIX_ARR,             "cyrix_arr")                               \
+    X(DCA,                   "dca")                                     \
+    X(DE,                    "de")                                      \
+    X(DECODEASSISTS,         "decodeassists")                           \
+    X(DS_CPL,                "ds_cpl")                                  \
+    X(DTES64,                "dtes64")                                  \
+    X(DTHERM,                "dtherm")                                  \
+    X(DTS,                   "dts")                                     \
+    X(ENQCMD,                "enqcmd")                                  \
+    X(EPB,                   "epb")                                     \
+    X(EPT,                   "ept")                                     \
+    X(EPT_AD,                "ept_ad")                                  \
+    X(ERMS,                  "erms")                                    \
+    X(EST,                   "est")                                     \
+    X(EXTAPIC,               "extapic")                                 \
+    X(EXTD_APICID,           "extd_apicid")                             \
+    X(F16C,                  "f16c")                                    \
+    X(FDP_EXCPTN_ONLY,       "fdp_excptn_only")                         \
+    X(FLEXPRIORITY,          "flexpriority")                            \
+    X(FLUSH_L1D,             "flush_l1d")                               \
+    X(FLUSHBYASID,           "flushbyasid")                             \
+    X(FMA,                   "fma")                                     \
+    X(FMA4,                  "fma4")                                    \
+    X(FPU,                   "fpu")                                     \
+    X(FSGSBASE,              "fsgsbase")                                \
+    X(FSRC,                  "fsrc")                                    \
+    X(FSRM,                  "fsrm")                                    \
+    X(FSRS,                  "fsrs")                                    \
+    X(FXSR,                  "fxsr")                                    \
+    X(FXSR_OPT,              "fxsr_opt")                                \
+    X(FZRM,                  "fzrm")                                    \
+    X(GFNI,                  "gfni")                                    \
+    X(HFI,                   "hfi")                                     \
+    X(HLE,                   "hle")                                     \
+    X(HT,                    "ht")                                      \
+    X(HW_PSTATE,             "hw_pstate")                               \
+    X(HWP,                   "hwp")                                     \
+    X(HWP_ACT_WINDOW,        "hwp_act_window")                          \
+    X(HWP_EPP,               "hwp_epp")                                 \
+    X(HWP_NOTIFY,            "hwp_notify")                              \
+    X(HWP_PKG_REQ,           "hwp_pkg_req")                             \
+    X(HYBRID_CPU,            "hybrid_cpu")                              \
+    X(HYPERVISOR,            "hypervisor")                              \
+    X(IA64,                  "ia64")                                    \
+    X(IBPB,                  "ibpb")                                    \
+    X(IBRS,                  "ibrs")                                    \
+    X(IBRS_ENHANCED,         "ibrs_enhanced")                           \
+    X(IBS,                   "ibs")                                     \
+    X(IBT,                   "ibt")                                     \
+    X(IDA,                   "ida")                                     \
+    X(INTEL_PT,              "intel_pt")                                \
+    X(INVPCID,               "invpcid")                                 \
+    X(INVPCID_SINGLE,        "invpcid_single")                          \
+    X(IRPERF,                "irperf")                                  \
+    X(K6_MTRR,               "k6_mtrr")                                 \
+    X(LA57,                  "la57")                                    \
+    X(LAHF_LM,               "lahf_lm")                                 \
+    X(LAM,                   "lam")                                     \
+    X(LBRV,                  "lbrv")                                    \
+    X(LM,                    "lm")                                      \
+    X(LONGRUN,               "longrun")                                 \
+    X(LRTI,                  "lrti")                                    \
+    X(LWP,                   "lwp")                                     \
+    X(MBA,                   "mba")                                     \
+    X(MCA,                   "mca")                                     \
+    X(MCE,                   "mce")                                     \
+    X(MD_CLEAR,              "md_clear")                                \
+    X(MISALIGNSSE,           "misalignsse")                             \
+    X(MMX,                   "mmx")                                     \
+    X(MMXEXT,                "mmxext")                                  \
+    X(MONITOR,               "monitor")                                 \
+    X(MOVBE,                 "movbe")                                   \
+    X(MOVDIR64B,             "movdir64b")                               \
+    X(MOVDIRI,               "movdiri")                                 \
+    X(MP,                    "mp")                                      \
+    X(MPX,                   "mpx")                                     \
+    X(MSR,                   "msr")                                     \
+    X(MTRR,                  "mtrr")                                    \
+    X(MWAITX,                "mwaitx")                                  \
+    X(NODEID_MSR,            "nodeid_msr")                              \
+    X(NONSTOP_TSC,           "nonstop_tsc")                             \
+    X(NONSTOP_TSC_S3,        "nonstop_tsc_s3")                          \
+    X(NOPL,                  "nopl")                                    \
+    X(NPT,                   "npt")                                     \
+    X(NRIP_SAVE,             "nrip_save")                               \
+    X(NX,                    "nx")                                      \
+    X(OSPKE,                 "ospke")                                   \
+    X(OSVW,                  "osvw")                                    \
+    X(OVERFLOW_RECOV,        "overflow_recov")                          \
+    X(PAE,                   "pae")                                     \
+    X(PAT,                   "pat")                                     \
+    X(PAUSEFILTER,           "pausefilter")                             \
+    X(PBE,                   "pbe")                                     \
+    X(PCID,                  "pcid")                                    \
+    X(PCLMULQDQ,             "pclmulqdq")                               \
+    X(PCONFIG,               "pconfig")                                 \
+    X(PDCM,                  "pdcm")                                    \
+    X(PDPE1GB,               "pdpe1gb")                                 \
+    X(PEBS,                  "pebs")                                    \
+    X(PERFCTR_CORE,          "perfctr_core")                            \
+    X(PERFCTR_LLC,           "perfctr_llc")                             \
+    X(PERFCTR_NB,            "perfctr_nb")                              \
+    X(PFTHRESHOLD,           "pfthreshold")                             \
+    X(PGE,                   "pge")                                     \
+    X(PHE,                   "phe")                                     \
+    X(PHE_EN,                "phe_en")                                  \
+    X(PKU,                   "pku")                                     \
+    X(PLN,                   "pln")                                     \
+    X(PMM,                   "pmm")                                     \
+    X(PMM_EN,                "pmm_en")                                  \
+    X(PN,                    "pn")                                      \
+    X(PNI,                   "pni")                                     \
+    X(POPCNT,                "popcnt")                                  \
+    X(PROC_FEEDBACK,         "proc_feedback")                           \
+    X(PSE,                   "pse")                                     \
+    X(PSE36,                 "pse36")                                   \
+    X(PTI,                   "pti")                                     \
+    X(PTS,                   "pts")                                     \
+    X(PTSC,                  "ptsc")                                    \
+    X(RAPL,                  "rapl")                                    \
+    X(RDPID,                 "rdpid")                                   \
+    X(RDPRU,                 "rdpru")                                   \
+    X(RDRAND,                "rdrand")                                  \
+    X(RDSEED,                "rdseed")                                  \
+    X(RDT_A,                 "rdt_a")                                   \
+    X(RDTSCP,                "rdtscp")                                  \
+    X(RECOVERY,              "recovery")                                \
+    X(REP_GOOD,              "rep_good")                                \
+    X(RING3MWAIT,            "ring3mwait")                              \
+    X(RNG,                   "rng")                                     \
+    X(RNG_EN,                "rng_en")                                  \
+    X(RTM,                   "rtm")                                     \
+    X(RTM_ALWAYS_ABORT,      "rtm_always_abort")                        \
+    X(SDBG,                  "sdbg")                                    \
+    X(SEP,                   "sep")                                     \
+    X(SERIALIZE,             "serialize")                               \
+    X(SEV,                   "sev")                                     \
+    X(SEV_ES,                "sev_es")                                  \
+    X(SGX,                   "sgx")                                     \
+    X(SGX_LC,                "sgx_lc")                                  \
+    X(SHA512,                "sha512")                                  \
+    X(SHA_NI,                "sha_ni")                                  \
+    X(SHSTK,                 "shstk")                                   \
+    X(SKINIT,                "skinit")                                  \
+    X(SM3,                   "sm3")                                     \
+    X(SM4,                   "sm4")                                     \
+    X(SMAP,                  "smap")                                    \
+    X(SMCA,                  "smca")                                    \
+    X(SME,                   "sme")                                     \
+    X(SMEP,                  "smep")                                    \
+    X(SMX,                   "smx")                                     \
+    X(SPEC_CTRL_SSBD,        "spec_ctrl_ssbd")                          \
+    X(SRBDS_CTRL,            "srbds_ctrl")                              \
+    X(SS,                    "ss")                                      \
+    X(SSBD,                  "ssbd")                                    \
+    X(SSE,                   "sse")                                     \
+    X(SSE2,                  "sse2")                                    \
+    X(SSE4_1,                "sse4_1")                                  \
+    X(SSE4_2,                "sse4_2")                                  \
+    X(SSE4A,                 "sse4a")                                   \
+    X(SSSE3,                 "ssse3")                                   \
+    X(STIBP,                 "stibp")                                   \
+    X(SUCCOR,                "succor")                                  \
+    X(SVM,                   "svm")                                     \
+    X(SVM_LOCK,              "svm_lock")                                \
+    X(SYSCALL,               "syscall")                                 \
+    X(TBM,                   "tbm")                                     \
+    X(TCE,                   "tce")                                     \
+    X(TM,                    "tm")                                      \
+    X(TM2,                   "tm2")                                     \
+    X(TME,                   "tme")                                     \
+    X(TOPOEXT,               "topoext")                                 \
+    X(TPR_SHADOW,            "tpr_shadow")                              \
+    X(TSC,                   "tsc")                                     \
+    X(TSC_ADJUST,            "tsc_adjust")                              \
+    X(TSC_DEADLINE_TIMER,    "tsc_deadline_timer")                      \
+    X(TSC_KNOWN_FREQ,        "tsc_known_freq")                          \
+    X(TSC_RELIABLE,          "tsc_reliable")                            \
+    X(TSC_SCALE,             "tsc_scale")                               \
+    X(TSX_FORCE_ABORT,       "tsx_force_abort")                         \
+    X(TSXLDTRK,              "tsxldtrk")                                \
+    X(UMIP,                  "umip")                                    \
+    X(UP,                    "up")                                      \
+    X(USER_SHSTK,            "user_shstk")                              \
+    X(V_SPEC_CTRL,           "v_spec_ctrl")                             \
+    X(V_VMSAVE_VMLOAD,       "v_vmsave_vmload")                         \
+    X(VAES,                  "vaes")                                    \
+    X(VGIF,                  "vgif")                                    \
+    X(VIRT_SSBD,             "virt_ssbd")                               \
+    X(VMCB_CLEAN,            "vmcb_clean")                              \
+    X(VME,                   "vme")                                     \
+    X(VMMCALL,               "vmmcall")                                 \
+    X(VMX,                   "vmx")                                     \
+    X(VNMI,                  "vnmi")                                    \
+    X(VPCLMULQDQ,            "vpclmulqdq")                              \
+    X(VPID,                  "vpid")                                    \
+    X(WAITPKG,               "waitpkg")                                 \
+    X(WBNOINVD,              "wbnoinvd")                                \
+    X(WDT,                   "wdt")                                     \
+    X(X2APIC,                "x2apic")                                  \
+    X(X2AVIC,                "x2avic")                                  \
+    X(XGETBV1,               "xgetbv1")                                 \
+    X(XOP,                   "xop")                                     \
+    X(XSAVE,                 "xsave")                                   \
+    X(XSAVEC,                "xsavec")                                  \
+    X(XSAVEERPTR,            "xsaveerptr")                              \
+    X(XSAVEOPT,              "xsaveopt")                                \
+    X(XSAVES,                "xsaves")                                  \
+    X(XTOPOLOGY,             "xtopology")                               \
+    X(XTPR,                  "xtpr")
+
+
+
+#define CPU_FLAG_ENUM(name, str)    CPU_FLAG_##name,
+#define CPU_FLAG_NAME(name, str)    str,
+
+// A known CPU flag, as a bit index into CPU_DATA.flags
+typedef enum
+{
+    CPU_FLAGS_LIST(CPU_FLAG_ENUM)
+    CPU_FLAGS_LEN
+} CPU_FLAG;
+
+// CPU_DATA.flags array size
+#define CPU_FLAG_WORDS  ((CPU_FLAGS_LEN + 31) / 32)
+
+
+
+// Each CPU_FLAG's cpuinfo name, in the same (sorted) order
+static const char *CPU_FLAG_NAMES[] = {
+    CPU_FLAGS_LIST(CPU_FLAG_NAME)
+};
+static const int CPU_FLAG_NAMES_LEN = sizeof(CPU_FLAG_NAMES) /
+    sizeof(CPU_FLAG_NAMES[0]);
+
+#undef CPU_FLAG_ENUM
+#undef CPU_FLAG_NAME
+
+#endif
@@ -0,0 +1,385 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to identifying x86   ##
+    ## CPUs with the CPUID instruction                  ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#include "cpuid.h"
+#include "io.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if !defined(NO_CPUID) && (defined(__i386__) || defined(__x86_64__))
+
+#include <cpuid.h>
+
+
+
+// Highest basic and extended leaves the CPU has, found once per read
+static unsigned int MAX_LEAF = 0;
+static unsigned int MAX_EXT_LEAF = 0;
+
+
+
+/**
+ * Runs CPUID for a leaf, if the CPU has it.
+ * @param leaf Leaf to run
+ * @param subleaf Subleaf to run (ignored by leaves without any)
+ * @param regs Receives EAX, EBX, ECX and EDX; all 0 if the leaf is not there
+ */
+static void runCPUID(const unsigned int leaf, const unsigned int subleaf,
+    unsigned int regs[4])
+{
+    regs[CPUID_EAX] = regs[CPUID_EBX] = regs[CPUID_ECX] = regs[CPUID_EDX] = 0;
+    if (leaf <= (leaf & 0x80000000 ? MAX_EXT_LEAF : MAX_LEAF))
+        __cpuid_count(leaf, subleaf, regs[CPUID_EAX], regs[CPUID_EBX],
+            regs[CPUID_ECX], regs[CPUID_EDX]);
+}
+
+/**
+ * @return Register state the OS has enabled (XCR0); 0 if it has not enabled
+ *         XSAVE (OSXSAVE), in which case no AVX code can run
+ */
+static unsigned int readXCR0(void)
+{
+    unsigned int regs[4];
+    runCPUID(0x00000001, 0, regs);
+    if (!(regs[CPUID_ECX] & (1 << 27)))
+        return 0;
+
+    unsigned int low, high;
+    __asm__ volatile ("xgetbv" : "=a" (low), "=d" (high) : "c" (0));
+    (void)high;
+    return low;
+}
+
+/**
+ * @param path Path of a small text file
+ * @param needle Text to look for
+ * @return 1 if the file contains the text; 0 if not or it cannot be read
+ */
+static int fileContains(const char *path, const char *needle)
+{
+    int fd = openFileAt(AT_FDCWD, path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return 0;
+    char buffer[4096];
+    ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (len <= 0)
+        return 0;
+    buffer[len] = '\0';
+    return strstr(buffer, needle) != NULL;
+}
+
+/**
+ * Checks for the ways the kernel hides flags from /proc/cpuinfo that leave
+ * the OS' register state (XCR0) alone, e.g. when the Gather Data Sampling
+ * mitigation turns AVX off.
+ * @return 1 if the kernel may be hiding flags CPUID reports; 0 if not
+ */
+static int isKernelHidingFlags(void)
+{
+    return fileContains("/proc/cmdline", "clearcpuid=") ||
+        fileContains(
+            "/sys/devices/system/cpu/vulnerabilities/gather_data_sampling",
+            "AVX disabled");
+}
+
+/**
+ * Finds the logical processors and cores in each package, the same as
+ * cpuinfo's "siblings" and "cpu cores".
+ * @param cpu CPU_DATA struct being filled in (vendor already known)
+ * @return 1 if found; 0 if the CPU cannot report them for every core
+ */
+static int readCPUIDTopology(CPU_DATA *cpu)
+{
+    unsigned int regs[4];
+    int threads = 0, perCore = 1;
+
+    if (cpu->vendor[0] == 'A')
+    {
+        // Logical processors per package (NC) and, on CPUs with topology
+        // extensions, threads (or Bulldozer cores) per compute unit
+        runCPUID(0x80000008, 0, regs);
+        threads = (regs[CPUID_ECX] & 0xff) + 1;
+        runCPUID(0x80000001, 0, regs);
+        if (regs[CPUID_ECX] & (1 << 22))
+        {
+            runCPUID(0x8000001e, 0, regs);
+            perCore = ((regs[CPUID_EBX] >> 8) & 0xff) + 1;
+        }
+    }
+    else
+    {
+        // Hybrid CPUs mix cores with and without Hyper-Threading, so cores
+        // cannot be counted from the one we are running on
+        runCPUID(0x00000007, 0, regs);
+        if (regs[CPUID_EDX] & (1 << 15))
+            return 0;
+
+        // V2 extended topology (leaf 0x1F) adds levels above cores, whose
+        // last level counts every logical processor in the package
+        unsigned int leaf = 0x1f;
+        runCPUID(leaf, 0, regs);
+        if (regs[CPUID_EBX] == 0)
+        {
+            leaf = 0x0b;
+            runCPUID(leaf, 0, regs);
+        }
+
+        for (unsigned int level = 0; regs[CPUID_EBX] != 0 &&
+            ((regs[CPUID_ECX] >> 8) & 0xff) != 0; level++)
+        {
+            if (((regs[CPUID_ECX] >> 8) & 0xff) == 1)
+                perCore = regs[CPUID_EBX] & 0xffff;
+            threads = regs[CPUID_EBX] & 0xffff;
+            runCPUID(leaf, level + 1, regs);
+        }
+
+        // Older CPUs only report logical processors (leaf 0x1) and cores
+        // (leaf 0x4) per package
+        if (threads == 0)
+        {
+            runCPUID(0x00000001, 0, regs);
+            threads = regs[CPUID_EDX] & (1 << 28) ?
+                (regs[CPUID_EBX] >> 16) & 0xff : 1;
+            runCPUID(0x00000004, 0, regs);
+            int cores = (regs[CPUID_EAX] >> 26) + 1;
+            if (threads < cores)
+                threads = cores;
+            perCore = threads / cores;
+        }
+    }
+
+    if (threads <= 0 || perCore <= 0 || threads % perCore != 0)
+        return 0;
+    cpu->threads = threads;
+    cpu->cores = threads / perCore;
+    return 1;
+}
+
+/**
+ * Finds the cache size the same way as cpuinfo's "cache size", which is the
+ * last level cache on Intel and L2 cache on AMD.
+ * @param cpu CPU_DATA struct being filled in (vendor already known)
+ * @return 1 if found; 0 if not reported
+ */
+static int readCPUIDCache(CPU_DATA *cpu)
+{
+    unsigned int regs[4];
+
+    if (cpu->vendor[0] == 'A')
+    {
+        runCPUID(0x80000006, 0, regs);
+        cpu->cacheSize = regs[CPUID_ECX] >> 16;
+        return cpu->cacheSize > 0;
+    }
+
+    // Deterministic cache parameters (leaf 0x4), one subleaf per cache
+    int l1 = 0, l2 = 0, l3 = 0;
+    for (unsigned int i = 0; ; i++)
+    {
+        runCPUID(0x00000004, i, regs);
+        int type = regs[CPUID_EAX] & 0x1f;
+        if (type == 0)
+            break;
+
+        int size = (((regs[CPUID_EBX] >> 22) & 0x3ff) + 1) *
+            (((regs[CPUID_EBX] >> 12) & 0x3ff) + 1) *
+            ((regs[CPUID_EBX] & 0xfff) + 1) * (regs[CPUID_ECX] + 1) / 1024;
+        switch ((regs[CPUID_EAX] >> 5) & 0x7)
+        {
+            case 1: l1 += size; break;
+            case 2: l2 = size; break;
+            case 3: l3 = size; break;
+        }
+    }
+
+    cpu->cacheSize = l3 ? l3 : (l2 ? l2 : l1);
+    return cpu->cacheSize > 0;
+}
+
+/**
+ * @param vendor CPUID vendor string
+ * @param family Family number
+ * @param model Model number
+ * @return 1 if interpretCPU never needs more than CPUID gives for the CPU
+ *         (e.g. cpuinfo's clock speed, which older CPUs are told apart by);
+ *         0 if not
+ */
+static int isCPUIDEnough(const char *vendor, const int family,
+    const int model)
+{
+    if (strcmp(vendor, "GenuineIntel") == 0)
+        // Core 2 and newer, bar the Atom for the Intel Edison
+        return (family == 6 && model >= 0x0f && model != 0x4a) ||
+            family > 15;
+    if (strcmp(vendor, "AuthenticAMD") == 0)
+        // Family 10h (K10) and newer
+        return family >= 0x10;
+    return 0;
+}
+
+/**
+ * Identifies the CPU we are running on with CPUID, filling in everything
+ * cpuinfo would bar the processor index count and physical IDs.
+ * @param cpu Initialised CPU_DATA struct to fill in
+ * @return 1 if identified; 0 if CPUID cannot fully identify the CPU (e.g.
+ *         386s and early 486s without CPUID, or CPUs too old to report a
+ *         name), leaving the CPU_DATA struct as it was
+ */
+int readCPUID(CPU_DATA *cpu)
+{
+    unsigned int regs[4];
+    char vendor[VENDOR_LEN];
+
+    // __get_cpuid_max also checks the CPU has CPUID at all
+    MAX_LEAF = __get_cpuid_max(0, NULL);
+    MAX_EXT_LEAF = 0;
+    if (MAX_LEAF < 1)
+        return 0;
+
+    // Under a hypervisor, every CPUID traps to it, which makes identifying
+    // the CPU slower than reading cpuinfo (and its topology may not be what
+    // the kernel booted with)
+    runCPUID(0x00000001, 0, regs);
+    if (regs[CPUID_ECX] & (1u << 31))
+        return 0;
+    unsigned int signature = regs[CPUID_EAX];
+
+    // Without a brand string, the kernel names CPUs from its own tables
+    MAX_EXT_LEAF = __get_cpuid_max(0x80000000, NULL);
+    if (MAX_EXT_LEAF < 0x80000004)
+        return 0;
+
+    runCPUID(0x00000000, 0, regs);
+    memcpy(vendor, &regs[CPUID_EBX], 4);
+    memcpy(vendor + 4, &regs[CPUID_EDX], 4);
+    memcpy(vendor + 8, &regs[CPUID_ECX], 4);
+    vendor[12] = '\0';
+
+    // Family and model numbers are extended the same way as the kernel does
+    int family = (signature >> 8) & 0xf;
+    int model = (signature >> 4) & 0xf;
+    if (family == 0xf)
+        family += (signature >> 20) & 0xff;
+    if (family >= 6)
+        model += ((signature >> 16) & 0xf) << 4;
+    if (!isCPUIDEnough(vendor, family, model))
+        return 0;
+
+    CPU_DATA found = *cpu;
+    found.arch = X86;
+    found.vendor = vendor;
+    found.family = family;
+    found.model = model;
+    found.stepping = signature & 0xf;
+    if (!readCPUIDTopology(&found) || !readCPUIDCache(&found))
+        return 0;
+
+    // Base frequency, if reported (only newer Intel CPUs do)
+    runCPUID(0x00000016, 0, regs);
+    if (regs[CPUID_EAX] & 0xffff)
+        found.freq = regs[CPUID_EAX] & 0xffff;
+
+    runCPUID(0x80000008, 0, regs);
+    if (regs[CPUID_EAX] != 0)
+    {
+        found.physAddrSize = regs[CPUID_EAX] & 0xff;
+        found.virtAddrSize = (regs[CPUID_EAX] >> 8) & 0xff;
+    }
+
+    // Flags only come from a few leaves, so each is only run once (CPUID is
+    // slow under virtualisation). Flags whose instructions need registers the
+    // OS has not enabled are left out of cpuinfo by the kernel, so rather
+    // than guess what else it hid, cpuinfo is read instead.
+    unsigned int xcr0 = readXCR0();
+    int needsOS = 0;
+    unsigned int leaves[CPUID_FLAG_LEAVES_LEN][2];
+    unsigned int results[CPUID_FLAG_LEAVES_LEN][4];
+    int leavesLen = 0;
+    memset(found.flags, 0, sizeof(found.flags));
+    for (int i = 0; i < CPUID_FLAGS_LEN; i++)
+    {
+        const CPUID_FLAG *flag = &CPUID_FLAGS[i];
+        int j = 0;
+        while (j < leavesLen && (leaves[j][0] != flag->leaf ||
+            leaves[j][1] != flag->subleaf))
+            j++;
+        if (j == leavesLen)
+        {
+            if (leavesLen == CPUID_FLAG_LEAVES_LEN)
+                continue;
+            leaves[j][0] = flag->leaf;
+            leaves[j][1] = flag->subleaf;
+            runCPUID(flag->leaf, flag->subleaf, results[j]);
+            leavesLen++;
+        }
+
+        if (results[j][flag->reg] & (1u << flag->bit))
+        {
+            if ((xcr0 & flag->xcr0) != flag->xcr0)
+                return 0;
+            needsOS |= flag->xcr0 != 0;
+            setFlag(&found, flag->flag);
+        }
+    }
+    if (needsOS && isKernelHidingFlags())
+        return 0;
+
+    // The brand string is padded with spaces at either end on some CPUs
+    char name[49];
+    for (int i = 0; i < 3; i++)
+    {
+        runCPUID(0x80000002 + i, 0, regs);
+        memcpy(name + i * 16, regs, 16);
+    }
+    name[48] = '\0';
+    char *start = name;
+    while (*start == ' ')
+        start++;
+    int nameLen = strlen(start);
+    while (nameLen > 0 && start[nameLen - 1] == ' ')
+        start[--nameLen] = '\0';
+    if (nameLen == 0)
+        return 0;
+
+    found.vendor = strdup(vendor);
+    found.name = malloc(NAME_LEN);
+    if (!found.vendor || !found.name)
+    {
+        free(found.vendor);
+        free(found.name);
+        return 0;
+    }
+    snprintf(found.name, NAME_LEN, "%s", start);
+
+    *cpu = found;
+    return 1;
+}
+
+#else
+
+/**
+ * @return 0, as CPUID is unavailable in this build
+ */
+int readCPUID(CPU_DATA *cpu)
+{
+    (void)cpu;
+    return 0;
+}
+
+#endif
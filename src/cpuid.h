@@ -0,0 +1,101 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to identifying x86   ##
+    ## CPUs with the CPUID instruction                  ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#ifndef CPUID
+#define CPUID
+
+#include "cpu.h"
+
+
+
+// CPUID registers, as indexes into a leaf's results
+#define CPUID_EAX               0
+#define CPUID_EBX               1
+#define CPUID_ECX               2
+#define CPUID_EDX               3
+// Most different leaves CPUID_FLAGS may use
+#define CPUID_FLAG_LEAVES_LEN   4
+// Register state (XCR0 bits) the OS must save for a flag's instructions to
+// be usable: x87, SSE and AVX, and AVX-512's opmask and upper ZMM registers
+#define XCR0_X87                0x01
+#define XCR0_AVX                0x06
+#define XCR0_AVX512             0xe6
+
+
+
+// A CPU flag and the CPUID bit that reports it
+typedef struct {
+    CPU_FLAG flag;
+    unsigned int leaf;
+    unsigned int subleaf;
+    int reg;
+    int bit;
+    // XCR0 bits the OS must have enabled (0 if none are needed)
+    unsigned int xcr0;
+} CPUID_FLAG;
+
+
+
+#if !defined(NO_CPUID) && (defined(__i386__) || defined(__x86_64__))
+
+// Flags worth reporting in CPU_DATA.flags
+static const CPUID_FLAG CPUID_FLAGS[] = {
+    { CPU_FLAG_FPU,         0x00000001, 0, CPUID_EDX, 0,  0 },
+    { CPU_FLAG_TSC,         0x00000001, 0, CPUID_EDX, 4,  0 },
+    { CPU_FLAG_PAE,         0x00000001, 0, CPUID_EDX, 6,  0 },
+    { CPU_FLAG_CX8,         0x00000001, 0, CPUID_EDX, 8,  0 },
+    { CPU_FLAG_CMOV,        0x00000001, 0, CPUID_EDX, 15, 0 },
+    { CPU_FLAG_MMX,         0x00000001, 0, CPUID_EDX, 23, 0 },
+    { CPU_FLAG_FXSR,        0x00000001, 0, CPUID_EDX, 24, 0 },
+    { CPU_FLAG_SSE,         0x00000001, 0, CPUID_EDX, 25, 0 },
+    { CPU_FLAG_SSE2,        0x00000001, 0, CPUID_EDX, 26, 0 },
+    { CPU_FLAG_HT,          0x00000001, 0, CPUID_EDX, 28, 0 },
+    { CPU_FLAG_SYSCALL,     0x80000001, 0, CPUID_EDX, 11, 0 },
+    { CPU_FLAG_MP,          0x80000001, 0, CPUID_EDX, 19, 0 },
+    { CPU_FLAG_NX,          0x80000001, 0, CPUID_EDX, 20, 0 },
+    { CPU_FLAG_LM,          0x80000001, 0, CPUID_EDX, 29, 0 },
+    { CPU_FLAG_PNI,         0x00000001, 0, CPUID_ECX, 0,  0 },
+    { CPU_FLAG_SSSE3,       0x00000001, 0, CPUID_ECX, 9,  0 },
+    { CPU_FLAG_FMA,         0x00000001, 0, CPUID_ECX, 12, XCR0_AVX },
+    { CPU_FLAG_CX16,        0x00000001, 0, CPUID_ECX, 13, 0 },
+    { CPU_FLAG_SSE4_1,      0x00000001, 0, CPUID_ECX, 19, 0 },
+    { CPU_FLAG_SSE4_2,      0x00000001, 0, CPUID_ECX, 20, 0 },
+    { CPU_FLAG_MOVBE,       0x00000001, 0, CPUID_ECX, 22, 0 },
+    { CPU_FLAG_POPCNT,      0x00000001, 0, CPUID_ECX, 23, 0 },
+    { CPU_FLAG_AES,         0x00000001, 0, CPUID_ECX, 25, 0 },
+    { CPU_FLAG_XSAVE,       0x00000001, 0, CPUID_ECX, 26, XCR0_X87 },
+    { CPU_FLAG_AVX,         0x00000001, 0, CPUID_ECX, 28, XCR0_AVX },
+    { CPU_FLAG_F16C,        0x00000001, 0, CPUID_ECX, 29, XCR0_AVX },
+    { CPU_FLAG_LAHF_LM,     0x80000001, 0, CPUID_ECX, 0,  0 },
+    { CPU_FLAG_ABM,         0x80000001, 0, CPUID_ECX, 5,  0 },
+    { CPU_FLAG_BMI1,        0x00000007, 0, CPUID_EBX, 3,  0 },
+    { CPU_FLAG_AVX2,        0x00000007, 0, CPUID_EBX, 5,  XCR0_AVX },
+    { CPU_FLAG_BMI2,        0x00000007, 0, CPUID_EBX, 8,  0 },
+    { CPU_FLAG_AVX512F,     0x00000007, 0, CPUID_EBX, 16, XCR0_AVX512 },
+    { CPU_FLAG_AVX512DQ,    0x00000007, 0, CPUID_EBX, 17, XCR0_AVX512 },
+    { CPU_FLAG_AVX512CD,    0x00000007, 0, CPUID_EBX, 28, XCR0_AVX512 },
+    { CPU_FLAG_AVX512BW,    0x00000007, 0, CPUID_EBX, 30, XCR0_AVX512 },
+    { CPU_FLAG_AVX512VL,    0x00000007, 0, CPUID_EBX, 31, XCR0_AVX512 }
+};
+static const int CPUID_FLAGS_LEN = sizeof(CPUID_FLAGS) /
+    sizeof(CPUID_FLAGS[0]);
+
+#endif
+
+
+
+int readCPUID(CPU_DATA*);
+
+#endif
@@ -0,0 +1,169 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Corrections to x86 CPU names and specs that are  ##
+    ## decided by their numbers alone                   ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#ifndef CPURULES
+#define CPURULES
+
+
+
+// Bound of a CPU_RULE condition that is not checked
+#define CPU_RULE_ANY            -2
+
+
+
+// x86 vendors that CPU_RULES are keyed on, told apart the same way
+// interpretCPU always has (by the canonical vendor name's first letters)
+typedef enum
+{
+    X86_VENDOR_OTHER,
+    X86_VENDOR_AMD,
+    X86_VENDOR_CENTAUR,
+    X86_VENDOR_CYRIX,
+    X86_VENDOR_INTEL
+} X86_VENDOR;
+
+typedef enum
+{
+    // Replaces the CPU's name with the rule's text
+    CPU_RULE_NAME,
+    // Adds the rule's text to the end of the CPU's name
+    CPU_RULE_APPEND,
+    // Sets the core and thread counts to 1 if both are unknown, so that
+    // multi-CPU configurations of single-core CPUs are told apart
+    CPU_RULE_SINGLE_CORE
+} CPU_RULE_ACTION;
+
+// A correction for CPUs of a vendor and family whose model, stepping, cache
+// size, clock speed (freqMin <= freq < freqMax) and processor index count are
+// in the given ranges (any bound may be CPU_RULE_ANY)
+typedef struct {
+    X86_VENDOR vendor;
+    int family;
+    int modelMin;
+    int modelMax;
+    int steppingMin;
+    int steppingMax;
+    int cacheMin;
+    int cacheMax;
+    float freqMin;
+    float freqMax;
+    int minIndex;
+    CPU_RULE_ACTION action;
+    const char *text;
+} CPU_RULE;
+
+
+
+#define ANY CPU_RULE_ANY
+
+// Must stay sorted by vendor, family and modelMin, as a CPU's rules are found
+// by binary search. Rules for the same CPU are applied in order. Corrections
+// that depend on the CPU's name (or exact clock speeds) are made in
+// interpretCPU instead.
+static const CPU_RULE CPU_RULES[] = {
+    //  vendor            fam model     stepping  cache       freq      index
+    // --- AMD ---
+    // K6 Model 6 and Model 7 share a name
+    { X86_VENDOR_AMD,      5,  6,   6,   ANY, ANY, ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_NAME,          "AMD K6 (Model 6)" },
+    { X86_VENDOR_AMD,      5,  7,   7,   ANY, ANY, ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_NAME,          "AMD K6 (Model 7)" },
+    // A supposed K6-III may actually be a K6-III+ or K6-2+
+    { X86_VENDOR_AMD,      5,  13,  13,  0,   0,   ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_NAME,          "AMD K6-III+" },
+    { X86_VENDOR_AMD,      5,  13,  13,  4,   4,   ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_NAME,          "AMD K6-2+" },
+    // There are multiple generations of K7-era Athlon and Duron that can
+    // reuse model numbers or lack them completely, so the core name is always
+    // added (model 2's Pluto and Orion need exact clock speeds to tell apart)
+    // See: Athlon K7750MTR52B A (6-2-2), Athlon K7850MPR52B A (6-2-1),
+    //      Athlon K7100MNR53B A (6-2-2)
+    { X86_VENDOR_AMD,      6,  1,   1,   ANY, ANY, ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_APPEND,        " (Argon)" },
+    { X86_VENDOR_AMD,      6,  3,   3,   ANY, ANY, ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_APPEND,        " (Spitfire)" },
+    { X86_VENDOR_AMD,      6,  4,   4,   ANY, ANY, ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_APPEND,        " (Thunderbird)" },
+    // All Athlon MPs were single core, so a processor index count above 1 is
+    // a multi-CPU configuration rather than two cores
+    { X86_VENDOR_AMD,      6,  6,   6,   ANY, ANY, ANY,  ANY,  ANY, ANY, 2,
+        CPU_RULE_SINGLE_CORE,   NULL },
+    { X86_VENDOR_AMD,      6,  6,   6,   ANY, ANY, ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_APPEND,        " (Palomino)" },
+    { X86_VENDOR_AMD,      6,  7,   7,   ANY, ANY, ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_APPEND,        " (Morgan)" },
+    { X86_VENDOR_AMD,      6,  8,   8,   ANY, ANY, ANY,  ANY,  ANY, ANY, 2,
+        CPU_RULE_SINGLE_CORE,   NULL },
+    { X86_VENDOR_AMD,      6,  8,   8,   ANY, ANY, ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_APPEND,        " (Thoroughbred)" },
+    { X86_VENDOR_AMD,      6,  10,  10,  ANY, ANY, ANY,  ANY,  ANY, ANY, 2,
+        CPU_RULE_SINGLE_CORE,   NULL },
+    { X86_VENDOR_AMD,      6,  10,  10,  ANY, ANY, ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_APPEND,        " (Barton)" },
+    // Some entire models of K8-based Opterons (SledgeHammer, Athens/Troy and
+    // San Diego) were always single core
+    // See: Opteron 148 (E4), Opteron 246 (CG), Opteron 246 (E4),
+    //      Opteron 848 (E4)
+    { X86_VENDOR_AMD,      15, 5,   5,   ANY, ANY, ANY,  ANY,  ANY, ANY, 2,
+        CPU_RULE_SINGLE_CORE,   NULL },
+    { X86_VENDOR_AMD,      15, 37,  37,  ANY, ANY, ANY,  ANY,  ANY, ANY, 2,
+        CPU_RULE_SINGLE_CORE,   NULL },
+    { X86_VENDOR_AMD,      15, 39,  39,  ANY, ANY, ANY,  ANY,  ANY, ANY, 2,
+        CPU_RULE_SINGLE_CORE,   NULL },
+
+    // --- Centaur/IDT ---
+    // A supposed WinChip 2-3D may be a WinChip 2A
+    { X86_VENDOR_CENTAUR,  5,  8,   8,   7,   7,   ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_NAME,          "IDT WinChip 2A" },
+
+    // --- Intel ---
+    // Pentium OverDrives for Sockets 4 and 5 do not distinguish themselves by
+    // name from their base P5 or P54C Pentiums, but their 100+MHz clock
+    // speeds do, and the OverDrive for Socket 3 is guaranteed to be P54C
+    { X86_VENDOR_INTEL,    5,  1,   1,   ANY, ANY, ANY,  ANY,  100, ANY, ANY,
+        CPU_RULE_NAME,          "Intel Pentium OverDrive (P5)" },
+    { X86_VENDOR_INTEL,    5,  2,   2,   ANY, ANY, ANY,  ANY,  100, ANY, ANY,
+        CPU_RULE_NAME,          "Intel Pentium OverDrive (P54C)" },
+    { X86_VENDOR_INTEL,    5,  3,   3,   ANY, ANY, ANY,  ANY,  ANY, 84,  ANY,
+        CPU_RULE_NAME,          "Intel Pentium OverDrive (P54C)" },
+    // Dothan or older were all single core, which multi-CPU detection needs
+    { X86_VENDOR_INTEL,    6,  ANY, 13,  ANY, ANY, ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_SINGLE_CORE,   NULL },
+    // Pentium II OverDrive is actually a Deschutes core despite reporting the
+    // same model as Klamath
+    { X86_VENDOR_INTEL,    6,  3,   3,   2,   2,   ANY,  ANY,  ANY, ANY, ANY,
+        CPU_RULE_NAME,          "Intel Pentium II OverDrive (Deschutes)" },
+    // Pentium II (Deschutes) and the Deschutes-based Pentium II Xeon and
+    // Celeron (Covington) have basically the same CPU ID, but some can be
+    // told apart by cache size: 32KB = Celeron; 512KB = Pentium II (or the
+    // 512KB Xeon, which cannot presently be told apart); 1024/2048KB =
+    // Pentium II Xeon
+    { X86_VENDOR_INTEL,    6,  5,   5,   ANY, ANY, 32,   32,   ANY, ANY, ANY,
+        CPU_RULE_NAME,          "Intel Celeron (Covington)" },
+    { X86_VENDOR_INTEL,    6,  5,   5,   ANY, ANY, 1024, ANY,  ANY, ANY, ANY,
+        CPU_RULE_NAME,          "Intel Pentium II Xeon" }
+};
+static const int CPU_RULES_LEN = sizeof(CPU_RULES) / sizeof(CPU_RULES[0]);
+
+#undef ANY
+
+#ifdef TESTS
+
+// Number of times each of CPU_RULES has been applied
+extern int CPU_RULE_HITS[sizeof(CPU_RULES) / sizeof(CPU_RULES[0])];
+
+#endif
+
+#endif
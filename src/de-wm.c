@@ -13,9 +13,12 @@
 
 
 
+#include "arena.h"
 #include "de-wm.h"
 #include "general.h"
 #include "globals.h"
+#include "matcher.h"
+#include "process.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -23,10 +26,34 @@
 
 
 /**
+ * @return Matcher over the command names in our WM database, built on first
+ *         use
+ */
+static const PATTERN_MATCHER *getWMMatcher(void)
+{
+    static PATTERN_MATCHER matcher = { NULL, 0, NULL, NULL };
+    static int built = 0;
+
+    if (!built)
+    {
+        const char *cmds[WINDOW_MANAGERS_LEN];
+        for (int i = 0; i < WINDOW_MANAGERS_LEN; i++)
+            cmds[i] = WINDOW_MANAGERS[i].cmd;
+        buildMatcher(&matcher, cmds, WINDOW_MANAGERS_LEN);
+        built = 1;
+    }
+
+    return &matcher;
+}
+
+
+
+/**
+ * @param arena Arena to allocate the result from
  * @return String containing the active display environment's name; NULL if
  *         not found/applicable
  */
-char *getDE(void)
+char *getDE(MEM_ARENA *arena)
 {
     // If we don't think we're in a graphical environment, time to leave...
     if (!WAYLAND_PRESENT && !X11_PRESENT)
@@ -36,7 +63,7 @@ char *getDE(void)
 
     // Test standardised DE environment var
     if (XDG_CURRENT_DESKTOP && XDG_CURRENT_DESKTOP[0] != '\0')
-        de = strdup(XDG_CURRENT_DESKTOP);
+        de = arenaStrdup(arena, XDG_CURRENT_DESKTOP);
 
     // Do some cleaning if needed
     if (de)
@@ -51,10 +78,7 @@ char *getDE(void)
 
         // "Prettify" XFCE to Xfce
         if (strncmp(de, "XFCE", 4) == 0)
-        {
-            free(de);
-            de = strdup("Xfce");
-        }
+            strcpy(de, "Xfce");
 
         // Discard ":Unity7:ubuntu" from "Unity:Unity7:ubuntu" (etc.)
         if (strncmp(de, "Unity", 5) == 0)
@@ -75,11 +99,13 @@ char *getDE(void)
 }
 
 /**
- * @param de Desktop enivornment's name
+ * @param arena Arena to allocate the result from
+ * @param de Desktop enivornment's name, which is pointed at the result if
+ *           the DE is really the WM
  * @return String containing the active window manager's name; NULL if not
  *         found/applicable
  */
-char *getWM(char **de)
+char *getWM(MEM_ARENA *arena, char **de)
 {
     // If we don't think we're in a graphical environment, time to leave...
     if (!WAYLAND_PRESENT && !X11_PRESENT)
@@ -88,42 +114,31 @@ char *getWM(char **de)
     // Cinnamon's WM (Muffin) is internal, we have to assume instead of look
     // for the process
     if (de && *de && strstr(*de, "Cinnamon") != NULL)
-        return strdup("Muffin");
+        return arenaStrdup(arena, "Muffin");
+
+    // Find the highest priority WM in our database with a running process,
+    // testing each process name against every WM in one scan
+    const PROC_TABLE *procs = getProcTable();
+    const PATTERN_MATCHER *matcher = getWMMatcher();
+    int found = -1;
+    for (int i = 0; i < procs->count && found != 0; i++)
+    {
+        int match = matchFirst(matcher, procs->procs[i].comm, 0);
+        if (match != -1 && (found == -1 || match < found))
+            found = match;
+    }
 
-    // Run through our WM database
-    for (int i = 0; i < WINDOW_MANAGERS_LEN; i++)
+    if (found != -1)
     {
-        if (procExists(WINDOW_MANAGERS[i].cmd, 0))
+        // If DE == WM, we may treat this as just a WM
+        if (de && *de && strcasestr(*de, WINDOW_MANAGERS[found].name) != NULL)
         {
-            // If DE == WM, we may treat this as just a WM
-            if (de && *de)
-            {
-                // Convert both subjects to all caps for a case-insensitive 
-                // comparison
-                char *deCaps = strdup(*de);
-                    for (int j = 0; deCaps[j]; j++)
-                        if (deCaps[j] >= 'a' && deCaps[j] <= 'z')
-                            deCaps[j] -= 32;
-                char *wmCaps = strdup(WINDOW_MANAGERS[i].name);
-                for (int j = 0; wmCaps[j]; j++)
-                    if (wmCaps[j] >= 'a' && wmCaps[j] <= 'z')
-                        wmCaps[j] -= 32;
-
-                if (strstr(deCaps, wmCaps) != NULL)
-                {
-                    free(deCaps);
-                    free(wmCaps);
-                    char *wm = strdup(WINDOW_MANAGERS[i].name);
-                    *de = wm;
-                    return wm;
-                }
-
-                free(deCaps);
-                free(wmCaps);
-            }
-
-            return strdup(WINDOW_MANAGERS[i].name);
+            char *wm = arenaStrdup(arena, WINDOW_MANAGERS[found].name);
+            *de = wm;
+            return wm;
         }
+
+        return arenaStrdup(arena, WINDOW_MANAGERS[found].name);
     }
 
     // If we haven't found a WM but we have a DE, there's a good chance DE/
@@ -16,6 +16,7 @@
 #ifndef DE_WM
 #define DE_WM
 
+#include "arena.h"
 #include "general.h"
 #include "globals.h"
 
@@ -74,7 +75,7 @@ static const int WINDOW_MANAGERS_LEN = sizeof(WINDOW_MANAGERS) /
 
 
 
-char *getDE(void);
-char *getWM(char **);
+char *getDE(MEM_ARENA *);
+char *getWM(MEM_ARENA *, char **);
 
 #endif
@@ -13,8 +13,10 @@
 
 
 
+#include "arena.h"
 #include "general.h"
 #include "globals.h"
+#include "io.h"
 #include "disk.h"
 
 #include <fcntl.h>
@@ -30,18 +32,22 @@
 
 /**
  * Gets a list of valid block device names and their total size.
+ * @param arena Arena to allocate the result from
  * @return DISKS pointer countaining the list and entry count
  */
-DISKS *getDisks(void)
+DISKS *getDisks(MEM_ARENA *arena)
 {
     // Get possible block devices 
-    DIR *blockDir = opendir("/sys/block");
+    DIR *blockDir = openDir("/sys/block");
     if (!blockDir)
         return NULL;
 
-    DISKS *result = malloc(sizeof(DISKS));
+    DISKS *result = arenaAlloc(arena, sizeof(DISKS));
     if (!result)
+    {
+        closedir(blockDir);
         return NULL;
+    }
     result->count = 0;
 
     // Read possible block devices beforehand
@@ -79,7 +85,7 @@ DISKS *getDisks(void)
         snprintf(sizePath, PATH_MAX, "/sys/block/%s/size", blockDevs[i]);
 
         // Get size
-        FILE *file = fopen(sizePath, "r");
+        FILE *file = openFile(sizePath, "r");
         if (!file)
             continue;
         unsigned long long sectors = 0;
@@ -90,17 +96,13 @@ DISKS *getDisks(void)
         unsigned long long size = sectors * 512ULL;
 
         // Convert size to str with appropriate unit
-        char *sizeStr = bytesToReadable("B", size);
-        if (!sizeStr || sizeStr[0] == '\0')
-        {
-            free(sizeStr);
+        char sizeStr[READABLE_LEN];
+        if (bytesToReadableInto(sizeStr, READABLE_LEN, "B", size) == 0)
             continue;
-        }
 
         // Add to disks
         snprintf(result->disks[result->count], DISK_LEN, "%s (%s)", sizeStr,
             blockDevs[i]);
-        free(sizeStr);
         result->count++;
     }
 
@@ -108,18 +110,19 @@ DISKS *getDisks(void)
 }
 
 /**
+ * @param arena Arena to allocate the result from
  * @return String containing the root partition's used and total size
- *         amounts both numerically and as a percentage
+ *         amounts both numerically and as a percentage; NULL if out of memory
  */
-char *getRoot(void)
+char *getRoot(MEM_ARENA *arena)
 {
-    char *root = malloc(ROOT_LEN);
+    char *root = arenaAlloc(arena, ROOT_LEN);
     if (!root)
-        return strdup("");
+        return NULL;
     root[0] = '\0';
 
     struct statvfs fs;
-    if (statvfs("/", &fs) != 0)
+    if (statFS("/", &fs) != 0)
         return root;
 
     long long total = (long long)fs.f_blocks * fs.f_frsize;
@@ -131,8 +134,9 @@ char *getRoot(void)
     long long freeRoot  = (long long)fs.f_bfree * fs.f_frsize;
     long long used  = total - freeRoot;
 
-    char *usedStr = bytesToReadable("B", used);
-    char *totalStr = bytesToReadable("B", total);
+    char usedStr[READABLE_LEN], totalStr[READABLE_LEN];
+    bytesToReadableInto(usedStr, READABLE_LEN, "B", used);
+    bytesToReadableInto(totalStr, READABLE_LEN, "B", total);
 
     if (!COMPACT)
     {
@@ -141,8 +145,5 @@ char *getRoot(void)
     }
     else snprintf(root, ROOT_LEN, "%s / %s", usedStr, totalStr);
 
-    free(usedStr);
-    free(totalStr);
-
     return root;
 }
@@ -16,6 +16,8 @@
 #ifndef DISK
 #define DISK
 
+#include "arena.h"
+
 #define DISK_LEN    259
 #define DISKS_LEN   10
 #define ROOT_LEN    64
@@ -29,7 +31,7 @@ typedef struct {
 
 
 
-DISKS *getDisks(void);
-char *getRoot(void);
+DISKS *getDisks(MEM_ARENA *);
+char *getRoot(MEM_ARENA *);
 
 #endif
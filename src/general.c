@@ -15,9 +15,12 @@
 
 #include "general.h"
 #include "globals.h"
+#include "io.h"
+#include "process.h"
 
 #include <ctype.h>
 #include <dirent.h>
+#include <fcntl.h>
 #include <sys/ioctl.h>
 #include <linux/limits.h>
 #include <sys/stat.h>
@@ -31,12 +34,19 @@
 /**
  * Converts a data value into a string formatted into a unit that makes sense for
  * its magnitude with its new unit added to the end.
+ * @param result Buffer to write the converted value to (READABLE_LEN is enough)
+ * @param resultSize Size of the result buffer
  * @param from Unit the input value is in (e.g., "B", "KiB")
  * @param val Input value to convert
- * @return String containing the converted value and its new unit (e.g., "1.5MiB")
+ * @return Length of the converted value and its new unit (e.g., "1.5MiB")
  */
-char *bytesToReadable(const char *from, const long long val)
+int bytesToReadableInto(char *result, const int resultSize, const char *from,
+    const long long val)
 {
+    if (!result || resultSize < 1)
+        return 0;
+    result[0] = '\0';
+
     long long bytes = val;
     if (strcmp(from, "KiB") == 0)
         bytes *= 1024;
@@ -52,9 +62,6 @@ char *bytesToReadable(const char *from, const long long val)
     const long long MiB = 1024LL * 1024;
     const long long KiB = 1024LL;
 
-    const int resultSize = 32;
-    char *result = malloc(resultSize);
-    if (!result) return strdup("");
     long long whole, remainder;
     int decimal;
 
@@ -67,7 +74,7 @@ char *bytesToReadable(const char *from, const long long val)
         {
             if (remainder > 0) whole++;
             snprintf(result, resultSize, "%lldT", whole);
-            return result;
+            return strlen(result);
         }
 
         decimal = (int)((remainder * 10 + TiB / 2) / TiB);
@@ -84,7 +91,7 @@ char *bytesToReadable(const char *from, const long long val)
         {
             if (remainder > 0) whole++;
             snprintf(result, resultSize, "%lldG", whole);
-            return result;
+            return strlen(result);
         }
 
         decimal = (int)((remainder * 10 + GiB / 2) / GiB);
@@ -101,7 +108,7 @@ char *bytesToReadable(const char *from, const long long val)
         {
             if (remainder > 0) whole++;
             snprintf(result, resultSize, "%lldM", whole);
-            return result;
+            return strlen(result);
         }
 
         decimal = (int)((remainder * 10 + MiB / 2) / MiB);
@@ -118,7 +125,7 @@ char *bytesToReadable(const char *from, const long long val)
         {
             if (remainder > 0) whole++;
             snprintf(result, resultSize, "%lldK", whole);
-            return result;
+            return strlen(result);
         }
 
         decimal = (int)((remainder * 10 + KiB / 2) / KiB);
@@ -129,7 +136,7 @@ char *bytesToReadable(const char *from, const long long val)
     else
         snprintf(result, resultSize, "%lldB", bytes);
 
-    return result;
+    return strlen(result);
 }
 
 /**
@@ -141,7 +148,7 @@ char *bytesToReadable(const char *from, const long long val)
  */
 char *captureProgramOutput(const char *command, const int bufferSize)
 {
-    FILE* stream = popen(command, "r");
+    FILE* stream = openProgram(command);
     if (!stream)
         return NULL;
 
@@ -174,50 +181,51 @@ char *captureProgramOutput(const char *command, const int bufferSize)
 }
 
 /**
- * Extracts a substring from an input string after a given separation character
- * and offset. Also removes any surrounding quotes or trailing newline characters
- * present. 
+ * Copies what comes after a given separation point in an input string, with
+ * any surrounding quotes or trailing newline characters removed.
  * @param input Input string
  * @param point Character to find to separate from (e.g., '=' or ':')
- * @param offset How many characters after the point to separate at
- * @param inputSize Size to use when allocating the result string
- * @return String containing what's left after separation and cleaning
+ * @param result Buffer to copy the cleaned value to
+ * @param resultSize Size of the result buffer
+ * @return Length of the cleaned value (0 if the point isn't found)
  */
-char *extractFromPoint(char *input, int inputSize, char point)
+int extractFromPointInto(const char *input, const char point, char *result,
+    const int resultSize)
 {
-    if (!input || inputSize < 2) return strdup("");
-
-    // Prepare result string
-    char *result = malloc(inputSize);
-    if (!result) return strdup("");
+    if (!result || resultSize < 1)
+        return 0;
     result[0] = '\0';
+    if (!input)
+        return 0;
 
     // Find our separation point in the input string
-    char *sep = strchr(input, point);
-    if (!sep) return result;
+    const char *start = strchr(input, point);
+    if (!start)
+        return 0;
 
-    // Make our start position take into account any possible offset
-    char *start = sep + 1;
+    // Skip past the point and any whitespace after it
+    start++;
     while (*start == ' ' || *start == '\t')
         start++;
 
     // Trim potential leading double quote
-    if (*start == '"') start++;
+    if (*start == '"')
+        start++;
 
     // Copy everything after the start position into our result
-    strncpy(result, start, inputSize - 1);
-    result[inputSize - 1] = '\0';
-    int len = strlen(result);
+    int len = strnlen(start, resultSize - 1);
+    memcpy(result, start, len);
+    result[len] = '\0';
 
-    // Trim potential trailing newline 
+    // Trim potential trailing newline
     if (len > 0 && result[len - 1] == '\n')
         result[--len] = '\0';
 
     // Trim potential trailing double quote
     if (len > 0 && result[len - 1] == '"')
-        result[len - 1] = '\0';
+        result[--len] = '\0';
 
-    return result;
+    return len;
 }
 
 /**
@@ -231,100 +239,81 @@ int fileExists(const char *file)
         return 0;
 
     struct stat st;
-    if (stat(file, &st) == 0 && S_ISREG(st.st_mode))
+    if (statPath(file, &st) == 0 && S_ISREG(st.st_mode))
         return 1;
     return 0;
 }
 
 /**
- * Finds and erases a desired substring from an input string.
- * @param input Input string
- * @param inputSize Size to use when allocating the result string
+ * Finds and erases every occurrence of a desired substring from a string in
+ * place.
+ * @param str String to edit
  * @param needle Substring to find and erase
- * @return String containing what's left after erasing
+ * @return Length of the string after erasing
  */
-char *findErase(const char *input, const int inputSize, const char *needle)
+int findEraseIn(char *str, const char *needle)
 {
-    if (!input || !needle || inputSize < 2) return strdup("");
-
-    int needleLen = strlen(needle);
-    if (needleLen == 0) return strdup("");
-
-    // Prepare result string
-    char *result = malloc(inputSize);
-    if (!result) return strdup("");
-
-    // Copy input string to result
-    strncpy(result, input, inputSize);
-    result[inputSize - 1] = '\0';
+    if (!str)
+        return 0;
+    int len = strlen(str);
+    int needleLen = needle ? strlen(needle) : 0;
+    if (needleLen == 0)
+        return len;
 
-    // Go through the string looking for our needle(s)... When found, we move the rest
-    // of the string over and on top of said needles
-    char *pos = result;
+    // Go through the string looking for our needle(s)... When found, we move
+    // the rest of the string over and on top of said needles
+    char *pos = str;
     while ((pos = strstr(pos, needle)) != NULL)
     {
-        int tailLen = strlen(pos + needleLen);
-        memmove(pos, pos + needleLen, tailLen + 1);
+        memmove(pos, pos + needleLen, len - (pos - str) - needleLen + 1);
+        len -= needleLen;
     }
 
-    return result;
+    return len;
 }
 
 /**
- * Finds and replaces a given search term with a desired replacement term from an
- * input string.
- * @param input Input string
- * @param inputSize Size to use when allocating the result string
+ * Finds and replaces every occurrence of a given search term with a desired
+ * replacement term in a string in place. If a replacement would not fit in the
+ * string's buffer, the end of the string is cut off.
+ * @param str String to edit
+ * @param size Size of the string's buffer
  * @param needle Substring to find and replace
  * @param replacement New string to insert
- * @return String after term replacement
+ * @return Length of the string after term replacement
  */
-char *findReplace(const char *input, const int inputSize, const char *needle, const char *replacement)
+int findReplaceIn(char *str, const int size, const char *needle,
+    const char *replacement)
 {
-    if (!input || !needle || !replacement || inputSize < 2) 
-        return strdup("");
-
-    int needleLen = strlen(needle);
+    if (!str || size < 1)
+        return 0;
+    int len = strnlen(str, size - 1);
+    str[len] = '\0';
+    int needleLen = needle ? strlen(needle) : 0;
+    if (needleLen == 0 || !replacement)
+        return len;
     int replacementLen = strlen(replacement);
-    if (needleLen == 0)
-        return strdup("");
 
-    // Prepare result string
-    char *result = malloc(inputSize);
-    if (!result)
-        return strdup("");
-
-    // Copy input string to result
-    strncpy(result, input, inputSize);
-    result[inputSize - 1] = '\0';
-
-    char *pos = result;
+    char *pos = str;
     while ((pos = strstr(pos, needle)) != NULL)
     {
-        int tailLen = strlen(pos + needleLen);
-
-        if (replacementLen > needleLen)
-        {
-            int currentLen = strlen(result);
-            int newLen = currentLen + (replacementLen - needleLen) + 1;
-            if (newLen < inputSize)
-                newLen = inputSize;
-            int offset = pos - result;
-            char *tmp = realloc(result, newLen);
-            if (!tmp)
-                break;
-            result = tmp;
-            pos = result + offset;
-        }
-
-        // Move the trailing text to accomodate the new size and paste our
-        // replacement into the 'gap'
-        memmove(pos + replacementLen, pos + needleLen, tailLen + 1);
-        memcpy(pos, replacement, replacementLen);
-        pos += replacementLen;
+        int at = pos - str;
+        // Move the trailing text to accomodate the new size (cutting off
+        // whatever no longer fits) and paste our replacement into the 'gap'
+        int pasteLen = replacementLen;
+        if (at + pasteLen > size - 1)
+            pasteLen = size - 1 - at;
+        int tailLen = len - at - needleLen;
+        if (at + pasteLen + tailLen > size - 1)
+            tailLen = size - 1 - at - pasteLen;
+        memmove(pos + pasteLen, pos + needleLen, tailLen);
+        memcpy(pos, replacement, pasteLen);
+        len = at + pasteLen + tailLen;
+        str[len] = '\0';
+        pos += pasteLen;
     }
 
-    return result;
+    return len;
 }
 
 /**
@@ -385,35 +374,15 @@ PROCESS getParentProcess(int pid)
 {
     PROCESS result = { -1, "" };
 
-    // Open the process's status file
-    char pidPath[PATH_MAX];
-    snprintf(pidPath, sizeof(pidPath), "/proc/%d/status", pid);
-    FILE *pidStatus = fopen(pidPath, "r");
-    if (!pidStatus) return result;
-
-    char buffer[256];
-    while (fgets(buffer, sizeof(buffer), pidStatus))
-    {
-        // Look for the PPid field in the status file
-        if (sscanf(buffer, "PPid: %d", &result.pid) == 1)
-        {
-            fclose(pidStatus);
-
-            // Get parent process' name
-            char commPath[PATH_MAX];
-            snprintf(commPath, sizeof(commPath), "/proc/%d/comm", result.pid);
-            FILE *comm = fopen(commPath, "r");
-            if (!comm) { result.pid = -1; return result; }
-
-            fgets(result.name, sizeof(result.name), comm);
-            result.name[strcspn(result.name, "\n")] = '\0';
-            fclose(comm);
+    // Look up the process, then its parent, in the process table snapshot
+    const PROC_ENTRY *proc = findProc(pid);
+    if (!proc) return result;
 
-            return result;
-        }
-    }
+    const PROC_ENTRY *parent = findProc(proc->ppid);
+    if (!parent) return result;
 
-    fclose(pidStatus);
+    result.pid = parent->pid;
+    snprintf(result.name, sizeof(result.name), "%s", parent->comm);
     return result;
 }
 
@@ -439,7 +408,7 @@ int isFileExecutable(char *currPath, struct dirent *entry)
 {
     char filePath[PATH_MAX + 256];
     snprintf(filePath, PATH_MAX + 256, "%s/%s", currPath, entry->d_name);
-    if (access(filePath, X_OK) == 0) return 1;
+    if (accessPath(filePath, X_OK) == 0) return 1;
     else return 0;
 }
 
@@ -492,35 +461,36 @@ int isProgramInstalled(char *prog, int isExec)
 
     // If prog contains '/' treat it as a full path
     if (strchr(prog, '/') != NULL)
-        return (access(prog, mode) == 0);
+        return (accessPath(prog, mode) == 0);
 
     char *path = getenv("PATH");
     if (!path)
     {
         char cmd[64];
         snprintf(cmd, 64, "%s --version > /dev/null 2>&1", prog);
-        return (system(cmd) == 0);
+        return (runProgram(cmd) == 0);
     }
 
     char *paths = strdup(path);
-    char *dir = strtok(paths, ":");
+    char *savePtr = NULL;
+    char *dir = strtok_r(paths, ":", &savePtr);
     while (dir)
     {
         char fullPath[PATH_MAX];
         snprintf(fullPath, sizeof(fullPath), "%s/%s", dir, prog);
-        if (access(fullPath, mode) == 0)
+        if (accessPath(fullPath, mode) == 0)
         {
             free(paths);
             return 1;
         }
-        dir = strtok(NULL, ":");
+        dir = strtok_r(NULL, ":", &savePtr);
     }
     free(paths);
 
     // Also try /usr/libexec
     char libexecPath[PATH_MAX];
     snprintf(libexecPath, PATH_MAX, "/usr/libexec/%s", prog);
-    if (access(libexecPath, mode) == 0) return 1;
+    if (accessPath(libexecPath, mode) == 0) return 1;
 
     return 0;
 }
@@ -659,57 +629,26 @@ int natCmp(const void *a, const void *b)
 }
 
 /**
- * Checks if a given process name is presently running and via the /proc 
- * filesystem.
+ * Checks if a given process name is presently running via the process table
+ * snapshot.
  * @param name The process name to find
  * @param strict Flags if we are looking for an exact match (1) or not (0)
  * @return 1 if found; 0 if not found or error
  */
 int procExists(const char *name, const int strict)
 {
-    DIR *proc = opendir("/proc");
-    if (!proc) return 0;
+    const PROC_TABLE *table = getProcTable();
 
-    struct dirent *entry;
-    while ((entry = readdir(proc)) != NULL)
+    for (int i = 0; i < table->count; i++)
     {
-        // Skip non-numeric (not PID) entries
-        if (entry->d_name[0] < '0' || entry->d_name[0] > '9')
-            continue;
-
-        // Build path to process' comm (command) file
-        char path[PATH_MAX];
-        snprintf(path, sizeof(path), "/proc/%s/comm", entry->d_name);
-
-        FILE *commFile = fopen(path, "r");
-        if (!commFile) continue;
-
-        char commVal[TASK_COMM_LEN];
-        int found = 0;
-
-        if (fgets(commVal, TASK_COMM_LEN, commFile))
-        {
-            // Strip trailing newline
-            commVal[strcspn(commVal, "\n")] = '\0';
-
-            // If strict, we look for an exact match
-            if (strict)
-                found = strcmp(commVal, name) == 0;
-            // If not, we look for a substring
-            else
-                found = strstr(commVal, name) != NULL;
-        }
-
-        fclose(commFile);
+        const char *commVal = table->procs[i].comm;
 
-        if (found)
-        {
-            closedir(proc);
+        // If strict, we look for an exact match; if not, we look for a
+        // substring
+        if (strict ? strcmp(commVal, name) == 0 : strstr(commVal, name) != NULL)
             return 1;
-        }
     }
 
-    closedir(proc);
     return 0;
 }
 
@@ -720,62 +659,49 @@ int procExists(const char *name, const int strict)
  */
 int readHexFile(const char *path)
 {
-    FILE *fStream = fopen(path, "r");
-    if (!fStream) return 0;
+    // These are tiny sysfs attributes (e.g. "0x030000"), so one read() into
+    // a stack buffer is enough and spares a FILE and its buffer
+    int fd = openFileAt(AT_FDCWD, path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return 0;
+    char buf[32];
+    ssize_t len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (len <= 0) return 0;
+    buf[len] = '\0';
     int val;
-    if (fscanf(fStream, "%x", &val) != 1) val = 0;
-    fclose(fStream);
+    if (sscanf(buf, "%x", &val) != 1) val = 0;
     return val;
 }
 
 /**
- * Removes any bracketed/parenthesis contents from a given input string.
- * @param input Input string
- * @param inputSize Size to use when allocating the result string
- * @return Result string after operation
+ * Removes any bracketed/parenthesis contents from a string in place.
+ * @param str String to edit
+ * @return Length of the string after removal
  */
-char *removeBrackets(const char *input, const int inputSize)
+int removeBracketsIn(char *str)
 {
-    if (!input)
-        return NULL;
-
-    // In case the input size happens to be too small...
-    int inputLen = strlen(input);
-    if (inputLen == 0)
-        return NULL;
-    int allocSize = inputSize;
-    if (allocSize < inputLen + 1)
-        allocSize = inputLen + 1;
-
-    // Prepare result string
-    char *result = calloc(allocSize, 1);
-    if (!result)
-        return NULL;
+    if (!str)
+        return 0;
 
-    const char *src = input;
-    char *dst = result;
+    const char *src = str;
+    char *dst = str;
     int depth = 0;
     while (*src)
     {
         if (*src == '(')
-        {
             depth++;
-            src++;
-        }
         else if (*src == ')')
         {
             if (depth > 0)
                 depth--;
-            src++;
         }
         else if (depth == 0)
-            *dst++ = *src++;
-        else
-            src++;
+            *dst++ = *src;
+        src++;
     }
     *dst = '\0';
 
-    return result;
+    return dst - str;
 }
 
 /**
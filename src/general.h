@@ -36,6 +36,9 @@ typedef struct
 
 
 #define BREAK_CHARS_LEN     9
+// Size of a buffer that fits bytesToReadableInto's result for any size up to
+// the 8EiB a long long can count (e.g. "8388608.0TiB")
+#define READABLE_LEN        16
 #define TASK_COMM_LEN       24
 
 
@@ -46,12 +49,12 @@ static const char BREAK_CHARS[BREAK_CHARS_LEN] = { " _-+,./\\" };
 
 
 
-char *bytesToReadable(const char *, const long long);
+int bytesToReadableInto(char *, const int, const char *, const long long);
 char *captureProgramOutput(const char *, const int);
-char *extractFromPoint(char *, int, char);
+int extractFromPointInto(const char *, const char, char *, const int);
 int fileExists(const char*);
-char *findErase(const char *, const int, const char *);
-char *findReplace(const char *, const int, const char *, const char *);
+int findEraseIn(char *, const char *);
+int findReplaceIn(char *, const int, const char *, const char *);
 float fSqrt(float);
 char *getBinDir(void);
 PROCESS getParentProcess(int);
@@ -65,7 +68,7 @@ int loadCSVLine(char*, char *[], int);
 int natCmp(const void*, const void*);
 int procExists(const char*, const int);
 int readHexFile(const char*);
-char *removeBrackets(const char*, const int);
+int removeBracketsIn(char *);
 void splitText(char*, char*[], int);
 WORD_WRAPPED *wordWrap(char*, int, char*, int, int);
 
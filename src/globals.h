@@ -31,33 +31,6 @@ typedef enum
 #define MAX_FIELDS  50
 #define OUTPUT_LEN  8192
 
-static const char *POSSIBLE_FIELDS[] =
-{
-    " ",    // Blank line
-    "---",  // Separator
-    "os",   // Operating system
-    "krn",  // Kernel
-    "upt",  // Uptime
-    "pkgs", // Packages
-    "scn",  // Screen(s)
-    "de",   // Desktop environment
-    "wm",   // Window manager and/or Wayland compositor
-    "trm",  // Terminal emulator/console size
-    "sh",   // Shell
-    "cpu",  // CPU
-    "gpu",  // GPU(s)
-    "ram",  // System memory
-    "swap", // Swap memory
-    "dsk",  // Disk sizes
-    "root", // Root partition size
-    "lip",  // Local IP address
-    "clrs", // ANSI escape code 16-colour palette
-    "clba", // ANSI escape code base 8-colour palette
-    "clbr"  // ANSI escape code bright 8-colour palette
-};
-static const int POSSIBLE_FIELDS_LEN = sizeof(POSSIBLE_FIELDS) /
-    sizeof(POSSIBLE_FIELDS[0]);
-
 extern char *COLOUR;
 extern int COMPACT;
 extern char *HOME;
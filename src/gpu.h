@@ -18,8 +18,15 @@
 
 
 
-#define GPU_NAME_LEN    256
-#define MAX_GPUS        4
+#define GPU_NAME_LEN        256
+// Longest PCI bus ID kept (including the terminator), e.g. "0000:01:00.0"
+#define GPU_BUS_ID_LEN      16
+// Largest uevent read for a DRM card's PCI device
+#define GPU_UEVENT_LEN      512
+// Room first made for GPUs (the list grows as more are found)
+#define GPUS_START_LEN      4
+// Where in the cache directory to remember where NixOS' pci.ids was found
+#define NIX_PCIIDS_CACHE    "nixpciids"
 
 
 
@@ -28,13 +35,38 @@ typedef struct {
     int vendor;
     int device;
     int revision;
+    // Where the GPU is in /sys/bus/pci/devices; empty if unknown
+    char busID[GPU_BUS_ID_LEN];
 } GPU_IDS;
 
+typedef struct {
+    int vendor;
+    const char *name;
+} GPU_VENDOR;
+
+
+
+// Vendor names to go with the product names drivers report in sysfs, which
+// do not include one
+static const GPU_VENDOR SYSFS_GPU_VENDORS[] = {
+    { 0x1002, "Advanced Micro" },
+    { 0x10de, "NVIDIA" },
+    { 0x8086, "Intel" }
+};
+static const int SYSFS_GPU_VENDORS_LEN = sizeof(SYSFS_GPU_VENDORS) /
+    sizeof(SYSFS_GPU_VENDORS[0]);
+
 
 
 #ifndef NO_STR_CLEANING
 
-extern const char *INTEL_IGPUS[];
+typedef struct {
+    unsigned short device;
+    const char *name;
+} INTEL_IGPU;
+
+extern const INTEL_IGPU INTEL_IGPUS[];
+extern const int INTEL_IGPUS_LEN;
 
 #endif
 
@@ -42,6 +74,8 @@ extern const char *INTEL_IGPUS[];
 
 char *cleanGPUName(const char*, const char*, const int);
 GPU_IDS* getGPUs(int *);
+int *groupGPUs(GPU_IDS*, int *);
 char *interpretGPU(GPU_IDS*, const char *);
+char **interpretGPUs(GPU_IDS*, const int, const char *);
 
 #endif
@@ -13,6 +13,7 @@
 
 
 
+#include "arena.h"
 #include "hostname.h"
 
 #include <string.h>
@@ -20,13 +21,15 @@
 
 
 /**
+ * @param arena Arena to allocate the result from
  * @param u Parsed uname data
  * @param uStatus The status returned from uname attempt
- * @return String containing the hostname; "unknown" if undetermined/error
+ * @return String containing the hostname; "unknown" if undetermined/error;
+ *         NULL if out of memory
  */
-char *getHostname(struct utsname u, int uStatus)
+char *getHostname(MEM_ARENA *arena, struct utsname u, int uStatus)
 {
     if (uStatus == 0)
-        return strdup(u.nodename);
-    return strdup("unknown");
+        return arenaStrdup(arena, u.nodename);
+    return arenaStrdup(arena, "unknown");
 }
@@ -16,10 +16,12 @@
 #ifndef HOSTNAME
 #define HOSTNAME
 
+#include "arena.h"
+
 #include <sys/utsname.h>
 
 
 
-char *getHostname(struct utsname, int);
+char *getHostname(MEM_ARENA *, struct utsname, int);
 
 #endif
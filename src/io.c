@@ -0,0 +1,241 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to opening files and ##
+    ## running programs, and accounting for doing so    ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#include "io.h"
+
+#include <fcntl.h>
+#include <linux/limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+
+
+// Directory that absolute paths are relative to instead of /; NULL if none.
+// Only set before collection starts, so it needs no lock.
+static char *SYSROOT = NULL;
+// Counts are per thread, so each collector's can be told apart when they run
+// on worker threads
+static __thread int FILES_OPENED = 0;
+static __thread int SUBPROCESSES = 0;
+// Bytes this thread has read from its own I/O counters, which must not count
+// towards what it has read otherwise
+static __thread long long SELF_BYTES = 0;
+
+
+
+/**
+ * Puts a path under the sysroot, if there is one.
+ * @param path Path as it would be on a live system
+ * @param buffer Buffer to build the path under the sysroot in
+ * @param size Buffer's size
+ * @return Path to actually use (either the original path or the buffer)
+ */
+static const char *sysrootPath(const char *path, char *buffer, const int size)
+{
+    if (!SYSROOT || !path || path[0] != '/')
+        return path;
+    snprintf(buffer, size, "%s%s", SYSROOT, path);
+    return buffer;
+}
+
+
+
+/**
+ * @param path Path to file or directory
+ * @param mode access-style mode
+ * @return 0 if accessible; -1 if not
+ */
+int accessPath(const char *path, int mode)
+{
+    char buffer[PATH_MAX];
+    return access(sysrootPath(path, buffer, PATH_MAX), mode);
+}
+
+/**
+ * Adds what has happened since a snapshot to a running total.
+ * @param total Total to add to
+ * @param start Snapshot from getIOStats
+ */
+void addIOStats(IO_STATS *total, const IO_STATS *start)
+{
+    IO_STATS now = getIOStats();
+    total->usecs += now.usecs - start->usecs;
+    total->filesOpened += now.filesOpened - start->filesOpened;
+    total->subprocesses += now.subprocesses - start->subprocesses;
+
+    if (now.bytesRead == -1 || start->bytesRead == -1)
+        total->bytesRead = -1;
+    else if (total->bytesRead != -1)
+        total->bytesRead += now.bytesRead - start->bytesRead;
+}
+
+/**
+ * @return Snapshot of the time now and what the calling thread has done so far
+ */
+IO_STATS getIOStats(void)
+{
+    IO_STATS stats = { 0, -1, FILES_OPENED, SUBPROCESSES };
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    stats.usecs = (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+
+    // The kernel only counts a read once it is done, so the current read is
+    // never included but all earlier ones are
+    int fd = open("/proc/thread-self/io", O_RDONLY);
+    if (fd == -1) return stats;
+
+    char buffer[IO_STATS_BUFFER_LEN];
+    ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (len <= 0) return stats;
+
+    buffer[len] = '\0';
+    long long rchar;
+    if (sscanf(buffer, "rchar: %lld", &rchar) == 1)
+        stats.bytesRead = rchar - SELF_BYTES;
+    SELF_BYTES += len;
+
+    return stats;
+}
+
+/**
+ * @return Directory that absolute paths are relative to; NULL if it is /
+ */
+const char *getSysroot(void)
+{
+    return SYSROOT;
+}
+
+/**
+ * @param path Path to directory
+ * @return Directory stream; NULL if it could not be opened
+ */
+DIR *openDir(const char *path)
+{
+    char buffer[PATH_MAX];
+    DIR *dir = opendir(sysrootPath(path, buffer, PATH_MAX));
+    if (dir) FILES_OPENED++;
+    return dir;
+}
+
+/**
+ * @param path Path to file
+ * @param mode fopen-style mode string
+ * @return File stream; NULL if it could not be opened
+ */
+FILE *openFile(const char *path, const char *mode)
+{
+    char buffer[PATH_MAX];
+    FILE *file = fopen(sysrootPath(path, buffer, PATH_MAX), mode);
+    if (file) FILES_OPENED++;
+    return file;
+}
+
+/**
+ * @param dirFd File descriptor of the directory the path is relative to
+ * @param path Path to file, relative to the directory (absolute paths ignore
+ *             the directory, like openat)
+ * @param flags open-style flags
+ * @return File descriptor; -1 if it could not be opened
+ */
+int openFileAt(int dirFd, const char *path, int flags)
+{
+    char buffer[PATH_MAX];
+    int fd = openat(dirFd, sysrootPath(path, buffer, PATH_MAX), flags);
+    if (fd != -1) FILES_OPENED++;
+    return fd;
+}
+
+/**
+ * Runs a shell command with its output piped back to us. Programs are never
+ * run with a sysroot, as they would report on the live system instead.
+ * @param command Command to run
+ * @return Stream of the command's output (close with pclose); NULL if it could
+ *         not be run
+ */
+FILE *openProgram(const char *command)
+{
+    if (SYSROOT) return NULL;
+
+    FILE *stream = popen(command, "r");
+    if (stream) SUBPROCESSES++;
+    return stream;
+}
+
+/**
+ * Runs a shell command to completion. Programs are never run with a sysroot,
+ * as they would report on the live system instead.
+ * @param command Command to run
+ * @return The command's exit status as given by system(); -1 if not run
+ */
+int runProgram(const char *command)
+{
+    if (SYSROOT) return -1;
+
+    SUBPROCESSES++;
+    return system(command);
+}
+
+/**
+ * Makes every absolute path used from now on relative to a directory instead
+ * of /, such as a captured copy of another system's files.
+ * @param dir Directory to use; NULL, empty or / for none
+ * @return 1 if successful; 0 if the directory does not exist
+ */
+int setSysroot(const char *dir)
+{
+    free(SYSROOT);
+    SYSROOT = NULL;
+    if (!dir || dir[0] == '\0') return 1;
+
+    struct stat st;
+    if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode))
+        return 0;
+
+    // Drop trailing slashes so joined paths do not double up
+    int len = strlen(dir);
+    while (len > 0 && dir[len - 1] == '/')
+        len--;
+    if (len > 0)
+        SYSROOT = strndup(dir, len);
+    return 1;
+}
+
+/**
+ * Gets the details of a live filesystem. Unlike the other wrappers, this never
+ * uses the sysroot, as a captured tree's sizes are those of whatever
+ * filesystem it was copied onto rather than the system it came from.
+ * @param path Any path on the filesystem to get the details of
+ * @param fs Receives the filesystem's details
+ * @return 0 if successful; -1 if not
+ */
+int statFS(const char *path, struct statvfs *fs)
+{
+    return statvfs(path, fs);
+}
+
+/**
+ * @param path Path to file or directory
+ * @param st Receives the file's details
+ * @return 0 if successful; -1 if not
+ */
+int statPath(const char *path, struct stat *st)
+{
+    char buffer[PATH_MAX];
+    return stat(sysrootPath(path, buffer, PATH_MAX), st);
+}
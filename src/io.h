@@ -0,0 +1,52 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to opening files and ##
+    ## running programs, and accounting for doing so    ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#ifndef IO
+#define IO
+
+#include <dirent.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+typedef struct {
+    // Microseconds on the monotonic clock
+    long long usecs;
+    // Bytes read by system calls; -1 if unknown
+    long long bytesRead;
+    int filesOpened;
+    int subprocesses;
+} IO_STATS;
+
+
+
+#define IO_STATS_BUFFER_LEN 512
+
+
+
+int accessPath(const char *, int);
+void addIOStats(IO_STATS *, const IO_STATS *);
+IO_STATS getIOStats(void);
+const char *getSysroot(void);
+DIR *openDir(const char *);
+FILE *openFile(const char *, const char *);
+int openFileAt(int, const char *, int);
+FILE *openProgram(const char *);
+int runProgram(const char *);
+int setSysroot(const char *);
+int statFS(const char *, struct statvfs *);
+int statPath(const char *, struct stat *);
+
+#endif
@@ -13,6 +13,7 @@
 
 
 
+#include "arena.h"
 #include "ip.h"
 
 #include <net/if.h>
@@ -23,9 +24,11 @@
 
 
 /**
- * @return String containing this computer's local IP address
+ * @param arena Arena to allocate the result from
+ * @return String containing this computer's local IP address; NULL if not
+ *         found
  */
-char *getLocalIP(void)
+char *getLocalIP(MEM_ARENA *arena)
 {
     struct ifaddrs *ifs;
     struct ifaddrs *currIF;
@@ -52,7 +55,7 @@ char *getLocalIP(void)
         void *ifPtr = &((struct sockaddr_in *)currIF->ifa_addr)->sin_addr;
         if (inet_ntop(AF_INET, ifPtr, host, INET_ADDRSTRLEN)) 
         {
-            result = strdup(host);
+            result = arenaStrdup(arena, host);
             break;
         }
     }
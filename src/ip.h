@@ -16,6 +16,10 @@
 #ifndef IP
 #define IP
 
-char *getLocalIP(void);
+#include "arena.h"
+
+
+
+char *getLocalIP(MEM_ARENA *);
 
 #endif
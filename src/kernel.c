@@ -13,35 +13,30 @@
 
 
 
+#include "arena.h"
 #include "globals.h"
 #include "kernel.h"
 
-#include <stdlib.h>
 #include <string.h>
 #include <sys/utsname.h>
 
 
 
 /**
+ * @param arena Arena to allocate the result from
  * @param u Parsed uname data
  * @param uStatus The status returned from uname attempt
  * @return String containing the kernel version or "unknown" if
- *         undetermined/error
+ *         undetermined/error; NULL if out of memory
  */
-char *getKernel(struct utsname u, int uStatus)
+char *getKernel(MEM_ARENA *arena, struct utsname u, int uStatus)
 {
     if (uStatus != 0)
-        return strdup("unknown");
+        return arenaStrdup(arena, "unknown");
     const char *src = u.release;
 
     if (!COMPACT)
-    {
-        char *release = malloc(strlen(src) + 1);
-        if (!release)
-            return strdup("unknown");
-        strcpy(release, u.release);
-        return release; 
-    }
+        return arenaStrdup(arena, src);
     else
     {
         // Strip out any suffixes
@@ -54,9 +49,9 @@ char *getKernel(struct utsname u, int uStatus)
             i++;
         }
 
-        char *release = malloc(i + 1);
+        char *release = arenaAlloc(arena, i + 1);
         if (!release)
-            return strdup("unknown");
+            return NULL;
         memcpy(release, src, i);
         release[i] = '\0';
         return release;
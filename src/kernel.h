@@ -16,10 +16,12 @@
 #ifndef KERNEL
 #define KERNEL
 
+#include "arena.h"
+
 #include <sys/utsname.h>
 
 
 
-char *getKernel(struct utsname, int);
+char *getKernel(MEM_ARENA *, struct utsname, int);
 
 #endif
@@ -14,7 +14,9 @@
 
 
 
+#include "arena.h"
 #include "art.h"
+#include "collect.h"
 #include "colours.h"
 #include "conf.h"
 #include "cpu.h"
@@ -24,16 +26,13 @@
 #include "globals.h"
 #include "gpu.h"
 #include "hostname.h"
-#include "ip.h"
-#include "kernel.h"
+#include "io.h"
 #include "memory.h"
 #include "os.h"
-#include "packages.h"
+#include "pciids.h"
+#include "process.h"
 #include "screen.h"
-#include "shell.h"
-#include "terminal.h"
 #include "testing.h"
-#include "uptime.h"
 #include "username.h"
 
 #include <stdarg.h>
@@ -169,6 +168,23 @@ void showHelp(void)
     free(save->str);
     free(save);
 
+    WORD_WRAPPED *sysroot = wordWrap("--sysroot      Reads system files "
+        "from under the given directory instead of /, e.g., a captured copy "
+        "of another system (also set by SHORKFETCH_SYSROOT); no assignment "
+        "returns the current directory and exits\n", TERM_SIZE.ws_col,
+        "                ", 0, 0);
+    printf("%s", sysroot->str);
+    free(sysroot->str);
+    free(sysroot);
+
+    WORD_WRAPPED *timings = wordWrap("-t, --timings   Reports the time "
+        "taken, files opened, bytes read and programs run by each field to "
+        "stderr after the output; =csv reports them as CSV\n",
+        TERM_SIZE.ws_col, "                ", 0, 0);
+    printf("%s", timings->str);
+    free(timings->str);
+    free(timings);
+
     WORD_WRAPPED *version = wordWrap("-v, --version   Displays version "
         "number and exits\n\n", TERM_SIZE.ws_col, "                ", 0, 0);
     printf("%s", version->str);
@@ -184,8 +200,8 @@ void showHelp(void)
     free(colours);
 
     WORD_WRAPPED *fieldNames = wordWrap("Fields: os, krn, upt, pkgs, scn, "
-        "de, wm, trm, sh, cpu, gpu, ram, swap, dsk, root, lip, clrs, clba, "
-        "clbr, --- (separator), single blank space (new line)\n\n",
+        "de, wm, trm, sh, cpu, isa, gpu, ram, swap, dsk, root, lip, clrs, "
+        "clba, clbr, --- (separator), single blank space (new line)\n\n",
         TERM_SIZE.ws_col,
         NULL, 0, 0);
     printf("%s", fieldNames->str);
@@ -241,6 +257,9 @@ int main(int argc, char *argv[])
     int noEsc = 0;
     int noIP = 0;
     int saveConf = 0;
+    int timings = 0;
+    int timingsCSV = 0;
+    char *sysroot = getenv("SHORKFETCH_SYSROOT");
     VIEW_MODE mode = NORMAL;
 
     readConf(&bullet, &COLOUR, &COMPACT, &fields, &mode, &noEsc, &noIP, 
@@ -402,6 +421,42 @@ int main(int argc, char *argv[])
         else if (strcmp(argv[i], "-s") == 0 ||
             strcmp(argv[i], "--save") == 0)
             saveConf = 1;
+        else if (strncmp(argv[i], "--sysroot", 9) == 0)
+        {
+            // Find "=" as our needle
+            char *equalsNeedle = strchr(argv[i], '=');
+            if (!equalsNeedle)
+            {
+                printf("\"%s\"\n", sysroot ? sysroot : "");
+                free(COLOUR);
+                free(fields);
+                return 0;
+            }
+
+            sysroot = equalsNeedle + 1;
+        }
+        else if (strncmp(argv[i], "-t", 2) == 0 ||
+            strncmp(argv[i], "--timings", 9) == 0)
+        {
+            timings = 1;
+
+            // Find "=" as our needle
+            char *equalsNeedle = strchr(argv[i], '=');
+            if (equalsNeedle)
+            {
+                equalsNeedle++;
+                if (strcmp(equalsNeedle, "csv") == 0)
+                    timingsCSV = 1;
+                else if (strcmp(equalsNeedle, "table") != 0)
+                {
+                    printf("ERROR: unrecognised timings format \"%s\"\n",
+                        equalsNeedle);
+                    free(fields);
+                    free(COLOUR);
+                    return 1;
+                }
+            }
+        }
         else if (strcmp(argv[i], "-v") == 0 ||
             strcmp(argv[i], "--version") == 0)
         {
@@ -419,6 +474,14 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (!setSysroot(sysroot))
+    {
+        printf("ERROR: sysroot \"%s\" is not a directory\n", sysroot);
+        free(COLOUR);
+        free(fields);
+        return 1;
+    }
+
     // Field name accent colour escape sequence
     char *colAccent = NULL;
     // General colour reset escape sequence
@@ -452,6 +515,7 @@ int main(int argc, char *argv[])
 #ifdef TESTS
     testInterpretScreen();
     testInterpretGPU();
+    testInterpretISA();
     testGetCPU();
     return 0;
 #endif
@@ -460,7 +524,7 @@ int main(int argc, char *argv[])
 
     // Validate which field to display
     char *fieldsOrig = strdup(fields);
-    char fieldsProcessed[MAX_FIELDS][5];
+    FIELD_ID fieldsProcessed[MAX_FIELDS];
     int noFields = 0;
     if (fields && fields[0] != '\0')
     {
@@ -468,17 +532,8 @@ int main(int argc, char *argv[])
         while (currTok)
         {
             // Make sure current field is a known one
-            int valid = 0;
-            for (int i = 0; i < POSSIBLE_FIELDS_LEN; i++)
-            {
-                if (strcmp(currTok, POSSIBLE_FIELDS[i]) == 0)
-                {
-                    valid = 1;
-                    break;
-                }
-            }
-
-            if (valid)
+            int field = findField(currTok);
+            if (field != -1)
             {
                 if (noFields >= MAX_FIELDS)
                 {
@@ -490,9 +545,7 @@ int main(int argc, char *argv[])
                 }
 
                 // Queue this field up
-                strncpy(fieldsProcessed[noFields], currTok, 4);
-                fieldsProcessed[noFields][4] = '\0';
-                noFields++;
+                fieldsProcessed[noFields++] = field;
             }
             else
             {
@@ -510,24 +563,20 @@ int main(int argc, char *argv[])
         // remove any blank space padding above them.
         if (noEsc)
         {
+            const unsigned int palettes = FIELD_BIT(FIELD_CLRS) |
+                FIELD_BIT(FIELD_CLBA) | FIELD_BIT(FIELD_CLBR);
             int write = 0;
             for (int read = 0; read < noFields; read++)
             {
                 // Skip clrs, clba or clbr
-                if (strcmp(fieldsProcessed[read], "clrs") == 0 ||
-                    strcmp(fieldsProcessed[read], "clba") == 0 ||
-                    strcmp(fieldsProcessed[read], "clbr") == 0)
+                if (palettes & FIELD_BIT(fieldsProcessed[read]))
                     continue;
                 // Skip space if previous ele was clrs
-                if (strcmp(fieldsProcessed[read], " ") == 0 && read > 0 &&
-                    (strcmp(fieldsProcessed[read - 1], "clrs") == 0 ||
-                    strcmp(fieldsProcessed[read - 1], "clba") == 0 ||
-                    strcmp(fieldsProcessed[read - 1], "clbr") == 0))
+                if (fieldsProcessed[read] == FIELD_BLANK && read > 0 &&
+                    (palettes & FIELD_BIT(fieldsProcessed[read - 1])))
                     continue;
                 // Keep ele
-                if (write != read)
-                    strcpy(fieldsProcessed[write], fieldsProcessed[read]);
-                write++;
+                fieldsProcessed[write++] = fieldsProcessed[read];
             }
             noFields = write;
         }
@@ -542,8 +591,6 @@ int main(int argc, char *argv[])
 
 
 
-    MemInfo mi = getMemInfo();
-
     struct utsname u;
     int uStatus = uname(&u);
 
@@ -579,11 +626,16 @@ int main(int argc, char *argv[])
     char output[OUTPUT_LEN];
     int outputPos = 0;
 
+    // Every string found from here on is allocated from one arena, and freed
+    // all together at the end
+    MEM_ARENA arena;
+    initArena(&arena);
+
     // Print header
-    char *username = getUsername();
-    char *hostname = getHostname(u, uStatus);
+    char *username = getUsername(&arena);
+    char *hostname = getHostname(&arena, u, uStatus);
     int headerWidth = 12;
-    if (username[0] != '\0' && hostname[0] != '\0')
+    if (username && hostname && username[0] != '\0' && hostname[0] != '\0')
     {
         if (noEsc) printShorkLine(0);
         outputPos += writeOutput(output + outputPos, OUTPUT_LEN - outputPos,
@@ -592,717 +644,92 @@ int main(int argc, char *argv[])
         headerWidth = strlen(username) + 1 + strlen(hostname);
     }
 
-    // Some things are dependent on others, so we have to look them up
-    // regardless
-    char *os = getOS(u, uStatus);
-    char *de = getDE();
-    char *wm = getWM(&de);
-    char *gpuFromCPU = NULL;
-    CPU_DATA *cpu = getCPU("/proc/cpuinfo", &gpuFromCPU);
+    // Collect every requested field's value up front, then render them in
+    // field order below
+    COLLECTION collection;
+    memset(&collection, 0, sizeof(collection));
+    collection.arena = &arena;
+    collection.u = u;
+    collection.uStatus = uStatus;
+    collection.noIP = noIP;
+    collection.timings = timings;
+    collectFields(&collection, fieldsProcessed, noFields);
+
+    IO_STATS renderStats = { 0, 0, 0, 0 };
+    IO_STATS renderStart;
+    if (timings) renderStart = getIOStats();
 
     // Assemble output
     for (int i = 0; i < noFields; i++)
     {
-        if (strcmp(fieldsProcessed[i], " ") == 0)
+        switch (fieldsProcessed[i])
         {
-            if (noEsc) printShorkLine(0);
-            outputPos += writeOutput(output + outputPos,
-                OUTPUT_LEN - outputPos, "\n");
-        }
-        else if (strcmp(fieldsProcessed[i], "---") == 0)
-        {
-            if (noEsc) printShorkLine(0);
-            for (int i = 0; i < headerWidth; i++)
+            case FIELD_BLANK:
+                if (noEsc) printShorkLine(0);
                 outputPos += writeOutput(output + outputPos,
-                    OUTPUT_LEN - outputPos, "-");
-            outputPos += writeOutput(output + outputPos,
-                OUTPUT_LEN - outputPos, "\n");
-        }
-        else if (strcmp(fieldsProcessed[i], "os") == 0)
-        {
-            if (os && os[0] != '\0')
-            {
+                    OUTPUT_LEN - outputPos, "\n");
+                continue;
+            case FIELD_SEPARATOR:
                 if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sOS:%s       %s\n",
-                            colAccent, colReset, os);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sOS:%s  %s\n",
-                            colAccent, colReset, os);
-                }
-                else
-                {
-                    char icon[10] = {bullet};
+                for (int i = 0; i < headerWidth; i++)
                     outputPos += writeOutput(output + outputPos,
-                        OUTPUT_LEN - outputPos, " %s%s%s %s\n", colAccent,
-                        icon, colReset, os);
-                }
-            }
-        }
-        else if (strcmp(fieldsProcessed[i], "krn") == 0)
-        {
-            char *kernel = getKernel(u, uStatus);
-            if (kernel && kernel[0] != '\0')
+                        OUTPUT_LEN - outputPos, "-");
+                outputPos += writeOutput(output + outputPos,
+                    OUTPUT_LEN - outputPos, "\n");
+                continue;
+            case FIELD_CLRS:
+            case FIELD_CLBA:
+            case FIELD_CLBR:
             {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sKernel:%s   %s\n",
-                            colAccent, colReset, kernel);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sKrn:%s %s\n",
-                            colAccent, colReset, kernel);
-                }
-                else
-                {
-                    char icon[10] = {bullet};
+                ColourPalette palette = getColourPalette(SHOW_SHORK);
+                if (fieldsProcessed[i] != FIELD_CLBR)
                     outputPos += writeOutput(output + outputPos,
-                        OUTPUT_LEN - outputPos, " %s%s%s %s\n", colAccent,
-                        icon, colReset, kernel);
-                }
-            }
-            free(kernel);
-        }
-        else if (strcmp(fieldsProcessed[i], "upt") == 0)
-        {
-            char *uptime = getUptime();
-            if (uptime && uptime[0] != '\0')
-            {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sUptime:%s   %s\n",
-                            colAccent, colReset, uptime);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sUp:%s  %s\n",
-                            colAccent, colReset, uptime);
-                }
-                else
-                {
-                    char icon[10] = {bullet};
+                        OUTPUT_LEN - outputPos, "%s\n", palette.baseCols);
+                if (fieldsProcessed[i] != FIELD_CLBA)
                     outputPos += writeOutput(output + outputPos,
-                        OUTPUT_LEN - outputPos, " %s%s%s %s\n", colAccent,
-                        icon, colReset, uptime);
-                }
+                        OUTPUT_LEN - outputPos, "%s\n", palette.brightCols);
+                continue;
             }
-            free(uptime);
+            default:
+                break;
         }
-        else if (strcmp(fieldsProcessed[i], "pkgs") == 0)
+
+        FIELD_VALUE *value = &collection.values[fieldsProcessed[i]];
+        const FIELD_DESC *desc = &FIELDS[value->renderAs];
+        const char *label = COMPACT ? desc->compactLabel : desc->label;
+        const char *suffix = COMPACT ? desc->compactBulletSuffix :
+            desc->bulletSuffix;
+        int width = COMPACT ? FIELD_COMPACT_LABEL_WIDTH : FIELD_LABEL_WIDTH;
+
+        // Multi-line values only show their label on the first line, which
+        // is pluralised if there is more than one line
+        if (!COMPACT && value->count > 1 && desc->pluralLabel)
+            label = desc->pluralLabel;
+
+        for (int j = 0; j < value->count; j++)
         {
-            char *pkgs = getPackages(os);
-            if (pkgs && pkgs[0] != '\0')
+            const char *line = value->lines[j];
+            if (!line || line[0] == '\0')
+                continue;
+
+            if (noEsc) printShorkLine(0);
+            if (mode == NORMAL)
             {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
+                if (j == 0)
                 {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sPackages:%s %s\n",
-                            colAccent, colReset, pkgs);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sPkg:%s %s\n",
-                            colAccent, colReset, pkgs);
-                }
-                else
-                {
-                    char icon[10] = {bullet};
+                    int pad = width - (int)strlen(label) - 1;
                     outputPos += writeOutput(output + outputPos,
-                        OUTPUT_LEN - outputPos, " %s%s%s %s\n", colAccent,
-                        icon, colReset, pkgs);
-                }
-            }
-            free(pkgs);
-        }
-        else if (strcmp(fieldsProcessed[i], "scn") == 0)
-        {
-            int noScreens = 0;
-            Screen *screens = getScreens(&noScreens);
-            if (screens)
-            {
-                int pastFirst = 0;
-                for (int j = 0; j < noScreens; j++)
-                {
-                    char *screen = interpretScreen(&screens[j]);
-
-                    if (screen && screen[0] != '\0')
-                    {
-                        if (noEsc) printShorkLine(0);
-                        if (mode == NORMAL)
-                        {
-                            if (!COMPACT)
-                            {
-                                // No compact - no bullet - single screen
-                                if (noScreens == 1)
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "%sScreen:%s   %s\n", colAccent,
-                                        colReset, screen);
-                                // No compact - no bullet - multiple screens
-                                // - first screen
-                                else if (!pastFirst)
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "%sScreens:%s  %s\n", colAccent,
-                                        colReset, screen);
-                                // No compact - no bullet - multiple screens
-                                // - subsequent screens
-                                else 
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "          %s\n", screen);
-                            }
-                            else
-                            {
-                                // Compact - no bullet - single screen OR
-                                // multiple screens - first screen
-                                if (noScreens == 1 || !pastFirst)
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "%sScn:%s %s\n", colAccent,
-                                        colReset, screen);
-                                // Compact - no bullet - multiple screens -
-                                // subsequent screens
-                                else 
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "     %s\n", screen);
-                            }
-                        }
-                        else
-                        {
-                            char icon[10] = {bullet};
-                            outputPos += writeOutput(output + outputPos,
-                                OUTPUT_LEN - outputPos, " %s%s%s %s\n",
-                                colAccent, icon, colReset, screen);
-                        }
-                    }
-
-                    free(screen);
-                    pastFirst = 1;
-                }
-                free(screens);
-            }
-        }
-        else if (strcmp(fieldsProcessed[i], "de") == 0)
-        {
-            if (de && de != wm && de[0] != '\0')
-            {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sDE:%s       %s\n",
-                            colAccent, colReset, de);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sDE:%s  %s\n",
-                            colAccent, colReset, de);
+                        OUTPUT_LEN - outputPos, "%s%s:%s%*s%s\n", colAccent,
+                        label, colReset, pad > 1 ? pad : 1, "", line);
                 }
                 else
-                {
-                    char icon[10] = {bullet};
                     outputPos += writeOutput(output + outputPos,
-                        OUTPUT_LEN - outputPos, " %s%s%s %s\n", colAccent,
-                        icon, colReset, de);
-                }
-            }
-        }
-        else if (strcmp(fieldsProcessed[i], "wm") == 0)
-        {
-            if (wm && wm[0] != '\0')
-            {
-                if (noEsc) printShorkLine(0);
-                char server[32] = "";
-                if (!COMPACT)
-                {
-                    if (WAYLAND_PRESENT)
-                        snprintf(server, 32, " (Wayland)");
-                    else if (X11_PRESENT)
-                        snprintf(server, 32, " (X11)");
-                }
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sWM:%s       %s%s\n",
-                            colAccent, colReset, wm, server);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sWM:%s  %s\n",
-                            colAccent, colReset, wm);
-                }
-                else 
-                {
-                    char icon[10] = {bullet};
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s%s\n",
-                            colAccent, icon, colReset, wm, server);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s\n",
-                            colAccent, icon, colReset, wm);
-                }
-            }
-        }
-        else if (strcmp(fieldsProcessed[i], "trm") == 0)
-        {
-            char *trm = getTerminal();
-            if (trm && trm[0] != '\0')
-            {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos,
-                            "%sTerminal:%s %s (%dx%d)\n", colAccent,
-                            colReset, trm, TERM_SIZE.ws_col,
-                            TERM_SIZE.ws_row);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sTrm:%s %s\n",
-                            colAccent, colReset, trm);
-                }
-                else
-                {
-                    char icon[10] = {bullet};
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s (%dx%d)\n",
-                            colAccent, icon, colReset, trm,
-                            TERM_SIZE.ws_col, TERM_SIZE.ws_row);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s\n",
-                            colAccent, icon, colReset, trm);
-                }
+                        OUTPUT_LEN - outputPos, "%*s%s\n", width, "", line);
             }
-            // If we don't have a terminal name, we can at least still show
-            // the console size
             else
-            {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sConsole:%s  %dx%d\n",
-                            colAccent, colReset, TERM_SIZE.ws_col,
-                            TERM_SIZE.ws_row);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sCon:%s %dx%d\n",
-                            colAccent, colReset, TERM_SIZE.ws_col,
-                            TERM_SIZE.ws_row);
-                }
-                else
-                {
-                    char icon[10] = {bullet};
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos,
-                            " %s%s%s %dx%d console\n", colAccent, icon,
-                            colReset, TERM_SIZE.ws_col, TERM_SIZE.ws_row);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %dx%dch\n",
-                            colAccent, icon, colReset, TERM_SIZE.ws_col,
-                            TERM_SIZE.ws_row);
-                }
-            }
-            free(trm);
-        }
-        else if (strcmp(fieldsProcessed[i], "sh") == 0)
-        {
-            char *shell = getShell();
-            if (shell && shell[0] != '\0')
-            {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sShell:%s    %s\n",
-                            colAccent, colReset, shell);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sSh:%s  %s\n",
-                            colAccent, colReset, shell);
-                }
-                else
-                {
-                    char icon[10] = {bullet};
-                    outputPos += writeOutput(output + outputPos,
-                        OUTPUT_LEN - outputPos, " %s%s%s %s\n", colAccent,
-                        icon, colReset, shell);
-                }
-            }
-            free(shell);
-        }
-        else if (strcmp(fieldsProcessed[i], "cpu") == 0)
-        {
-            if (cpu)
-            {
-                char *cpuStr = interpretCPU(cpu);
-                if (cpuStr && cpuStr[0] != '\0')
-                {
-                    if (noEsc) printShorkLine(0);
-                    if (mode == NORMAL)
-                    {
-                        if (!COMPACT)
-                            outputPos += writeOutput(output + outputPos,
-                                OUTPUT_LEN - outputPos,
-                                "%sCPU:%s      %s\n", colAccent, colReset,
-                                cpuStr);
-                        else
-                            outputPos += writeOutput(output + outputPos,
-                                OUTPUT_LEN - outputPos, "%sCPU:%s %s\n",
-                                colAccent, colReset, cpuStr);
-                    }
-                    else
-                    {
-                        char icon[10] = {bullet};
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s\n",
-                            colAccent, icon, colReset, cpuStr);
-                    }
-                }
-                free(cpuStr);
-            }
-        }
-        else if (strcmp(fieldsProcessed[i], "gpu") == 0)
-        {
-            int noGPUs = 0;
-            GPU_IDS *gpus = getGPUs(&noGPUs);
-            if (gpus && noGPUs > 0)
-            {
-                int pastFirstGPU = 0;
-                for (int j = 0; j < noGPUs; j++)
-                {
-                    char *gpuStr = interpretGPU(&gpus[j], os);
-
-                    if (gpuStr && gpuStr[0] != '\0')
-                    {
-                        if (noEsc) printShorkLine(0);
-                        if (mode == NORMAL)
-                        {
-                            if (!COMPACT)
-                            {
-                                if (noGPUs == 1)
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "%sGPU:%s      %s\n", colAccent,
-                                        colReset, gpuStr);
-                                else if (!pastFirstGPU)
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "%sGPUs:%s     %s\n", colAccent,
-                                        colReset, gpuStr);
-                                else
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "          %s\n", gpuStr);
-                            }
-                            else
-                            {
-                                if (noGPUs == 1 || !pastFirstGPU)
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "%sGPU:%s %s\n", colAccent,
-                                        colReset, gpuStr);
-                                else
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "     %s\n", gpuStr);
-                            }
-                        }
-                        else
-                        {
-                            char icon[10] = {bullet};
-                            outputPos += writeOutput(output + outputPos,
-                                OUTPUT_LEN - outputPos, " %s%s%s %s\n",
-                                colAccent, icon, colReset, gpuStr);
-                        }
-                    }
-
-                    free(gpuStr);
-                    pastFirstGPU = 1;
-                }
-            }
-            // If we found no GPUs the "traditional" way, at least check if
-            // we received a fallback found during CPU name processing
-            else if (gpuFromCPU && gpuFromCPU[0] != '\0')
-            {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sGPU:%s      %s\n",
-                            colAccent, colReset, gpuFromCPU);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sGPU:%s %s\n",
-                            colAccent, colReset, gpuFromCPU);
-                }
-                else
-                {
-                    char icon[10] = {bullet};
-                    outputPos += writeOutput(output + outputPos,
-                        OUTPUT_LEN - outputPos, " %s%s%s %s\n", colAccent,
-                        icon, colReset, gpuFromCPU);
-                }
-            }
-            free(gpus);
-        }
-        else if (strcmp(fieldsProcessed[i], "ram") == 0 && mi.memTotal > 0)
-        {
-            char *ram = getRAM(mi);
-            if (ram && ram[0] != '\0')
-            {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sRAM:%s      %s\n",
-                            colAccent, colReset, ram);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sRAM:%s %s\n",
-                            colAccent, colReset, ram);
-                }
-                else 
-                {
-                    char icon[10] = {bullet};
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s RAM\n",
-                            colAccent, icon, colReset, ram);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s (R)\n",
-                            colAccent, icon, colReset, ram);
-                }
-            }
-            free(ram);
-        }
-        else if (strcmp(fieldsProcessed[i], "swap") == 0 &&
-            mi.swapTotal > 0)
-        {
-            char *swap = getSwap(mi);
-            if (swap && swap[0] != '\0')
-            {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sSwap:%s     %s\n",
-                            colAccent, colReset, swap);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sSwp:%s %s\n",
-                            colAccent, colReset, swap);
-                }
-                else 
-                {
-                    char icon[10] = {bullet};
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s swap\n",
-                            colAccent, icon, colReset, swap);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s (S)\n",
-                            colAccent, icon, colReset, swap);
-                }
-            }
-            free(swap);
-        }
-        else if (strcmp(fieldsProcessed[i], "dsk") == 0)
-        {
-            DISKS *disks = getDisks();
-            if (disks && disks->count > 0)
-            {
-                int pastFirst = 0;
-                for (int i = 0; i < disks->count; i++)
-                {
-                    if (disks->disks[i][0] != '\0')
-                    {
-                        if (noEsc) printShorkLine(0);
-                        if (mode == NORMAL)
-                        {
-                            if (!COMPACT)
-                            {
-                                // No compact - no bullet - single disk
-                                if (disks->count == 1)
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "%sDisk:%s     %s\n", colAccent,
-                                        colReset, disks->disks[i]);
-                                // No compact - no bullet - multiple disks -
-                                // first disk
-                                else if (!pastFirst)
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "%sDisks:%s    %s\n", colAccent,
-                                        colReset, disks->disks[i]);
-                                // No compact - no bullet - multiple disks -
-                                // subsequent disks
-                                else 
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "          %s\n", disks->disks[i]);
-                            }
-                            else
-                            {
-                                // Compact - no bullet - single disks OR
-                                // multiple disks - first screen
-                                if (disks->count == 1 || !pastFirst)
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos,
-                                        "%sDsk:%s %s\n", colAccent,
-                                        colReset, disks->disks[i]);
-                                // Compact - no bullet - multiple disks -
-                                // subsequent disks
-                                else 
-                                    outputPos += writeOutput(
-                                        output + outputPos,
-                                        OUTPUT_LEN - outputPos, "     %s\n",
-                                        disks->disks[i]);
-                            }
-                        }
-                        else
-                        {
-                            char icon[10] = {bullet};
-                            if (!COMPACT)
-                                outputPos += writeOutput(output + outputPos,
-                                    OUTPUT_LEN - outputPos,
-                                    " %s%s%s %s disk\n", colAccent, icon,
-                                    colReset, disks->disks[i]);
-                            else
-                                outputPos += writeOutput(output + outputPos,
-                                    OUTPUT_LEN - outputPos, " %s%s%s %s\n",
-                                    colAccent, icon, colReset,
-                                    disks->disks[i]);
-                        }
-                    }
-                    pastFirst = 1;
-                }
-            }
-            free(disks);
-        }
-        else if (strcmp(fieldsProcessed[i], "root") == 0)
-        {
-            char *root = getRoot();
-            if (root && root[0] != '\0')
-            {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sRoot:%s     %s\n",
-                            colAccent, colReset, root);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%s/:%s   %s\n",
-                            colAccent, colReset, root);
-                }
-                else 
-                {
-                    char icon[10] = {bullet};
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s root\n",
-                            colAccent, icon, colReset, root);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s (/)\n",
-                            colAccent, icon, colReset, root);
-                }
-            }
-            free(root);
-        }
-        else if (strcmp(fieldsProcessed[i], "lip") == 0 && !noIP)
-        {
-            char *localIP = getLocalIP();
-            if (localIP)
-            {
-                if (noEsc) printShorkLine(0);
-                if (mode == NORMAL)
-                {
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sLocal IP:%s %s\n",
-                            colAccent, colReset, localIP);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, "%sLoc:%s %s\n",
-                            colAccent, colReset, localIP);
-                }
-                else 
-                {
-                    char icon[10] = {bullet};
-                    if (!COMPACT)
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s local\n",
-                            colAccent, icon, colReset, localIP);
-                    else
-                        outputPos += writeOutput(output + outputPos,
-                            OUTPUT_LEN - outputPos, " %s%s%s %s (L)\n",
-                            colAccent, icon, colReset, localIP);
-                }
-                free(localIP);
-            }
-        }
-        else if (strcmp(fieldsProcessed[i], "clrs") == 0)
-        {
-            ColourPalette palette = getColourPalette(SHOW_SHORK);
-            outputPos += writeOutput(output + outputPos,
-                OUTPUT_LEN - outputPos, "%s\n", palette.baseCols);
-            outputPos += writeOutput(output + outputPos,
-                OUTPUT_LEN - outputPos, "%s\n", palette.brightCols);
-        }
-        else if (strcmp(fieldsProcessed[i], "clba") == 0)
-        {
-            ColourPalette palette = getColourPalette(SHOW_SHORK);
-            outputPos += writeOutput(output + outputPos,
-                OUTPUT_LEN - outputPos, "%s\n", palette.baseCols);
-        }
-        else if (strcmp(fieldsProcessed[i], "clbr") == 0)
-        {
-            ColourPalette palette = getColourPalette(SHOW_SHORK);
-            outputPos += writeOutput(output + outputPos,
-                OUTPUT_LEN - outputPos, "%s\n", palette.brightCols);
+                outputPos += writeOutput(output + outputPos,
+                    OUTPUT_LEN - outputPos, " %s%c%s %s%s\n", colAccent,
+                    bullet, colReset, line, suffix);
         }
     }
 
@@ -1376,6 +803,13 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (timings)
+    {
+        addIOStats(&renderStats, &renderStart);
+        fflush(stdout);
+        printTimings(&collection, &renderStats, timingsCSV);
+    }
+
     if (saveConf)
         writeConf(bullet, COLOUR, COMPACT, fieldsOrig, mode, noEsc, noIP,
             SHOW_SHORK);
@@ -1384,23 +818,11 @@ int main(int argc, char *argv[])
     free(colAccent);
     free(fieldsOrig);
     free(fields);
-    free(hostname);
-    free(os);
-    if (de != wm) free(de);
-    free(wm);
-    free(gpuFromCPU);
-    if (cpu)
-    {
-#ifndef X86_ONLY
-        free(cpu->processor);
-        free(cpu->uarch);
-        free(cpu->platform);
-        free(cpu->machine);
-#endif
-        free(cpu->vendor);
-        free(cpu->name);
-        free(cpu);
-    }
+    freeCollection(&collection);
+    freeArena(&arena);
+    freeProcTable();
+    freePCIIDs();
+    setSysroot(NULL);
 
     return 0;
 }
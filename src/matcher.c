@@ -0,0 +1,253 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to matching a table  ##
+    ## of patterns against a string in a single pass    ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#include "matcher.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+
+/**
+ * @param nodes The automaton's nodes
+ * @param node Node to search the children of
+ * @param c Byte on the edge to follow
+ * @return Index of the child node reached by c; -1 if there is none
+ */
+static int findChild(const MATCHER_NODE *nodes, int node, unsigned char c)
+{
+    int child = nodes[node].child;
+    while (child != -1 && nodes[child].c != c)
+        child = nodes[child].sibling;
+    return child;
+}
+
+/**
+ * @param matcher Matcher to use
+ * @param node Node reached so far
+ * @param c Next byte scanned
+ * @return Node reached by following c, or failing that the fail links
+ */
+static int nextNode(const PATTERN_MATCHER *matcher, int node,
+    const unsigned char c)
+{
+    const MATCHER_NODE *nodes = matcher->nodes;
+    for (; node != 0; node = nodes[node].fail)
+    {
+        int next = findChild(nodes, node, c);
+        if (next != -1)
+            return next;
+    }
+    return matcher->rootChildren[c];
+}
+
+
+
+/**
+ * Builds an Aho-Corasick automaton over a table of patterns. Empty or NULL
+ * patterns are ignored.
+ * @param matcher Matcher to build into
+ * @param patterns Table of patterns, in priority order
+ * @param count Number of patterns in the table
+ * @return 1 if successful; 0 if out of memory (the matcher then matches
+ *         nothing)
+ */
+int buildMatcher(PATTERN_MATCHER *matcher, const char *const *patterns,
+    const int count)
+{
+    // Worst case is one node per pattern byte, plus the root
+    int maxNodes = 1;
+    for (int i = 0; i < count; i++)
+        if (patterns[i])
+            maxNodes += strlen(patterns[i]);
+
+    matcher->count = 0;
+    matcher->nodes = malloc(maxNodes * sizeof(MATCHER_NODE));
+    matcher->duplicates = malloc((count > 0 ? count : 1) * sizeof(int));
+    matcher->rootChildren = calloc(256, sizeof(int));
+    int *queue = malloc(maxNodes * sizeof(int));
+    if (!matcher->nodes || !matcher->duplicates || !matcher->rootChildren ||
+        !queue)
+    {
+        free(queue);
+        freeMatcher(matcher);
+        return 0;
+    }
+
+    MATCHER_NODE *nodes = matcher->nodes;
+    nodes[0] = (MATCHER_NODE){ 0, -1, -1, 0, -1, -1 };
+    matcher->count = 1;
+
+    // Insert every pattern into the trie
+    for (int i = 0; i < count; i++)
+    {
+        matcher->duplicates[i] = -1;
+        if (!patterns[i] || patterns[i][0] == '\0')
+            continue;
+
+        int node = 0;
+        const unsigned char *c = (const unsigned char *)patterns[i];
+        for (; *c; c++)
+        {
+            int next = findChild(nodes, node, *c);
+            if (next == -1)
+            {
+                next = matcher->count++;
+                nodes[next] = (MATCHER_NODE){ *c, -1, nodes[node].child, 0, -1,
+                    -1 };
+                nodes[node].child = next;
+            }
+            node = next;
+        }
+
+        // Patterns are inserted in priority order, so an identical pattern
+        // already here always has a higher priority
+        if (nodes[node].pattern == -1)
+            nodes[node].pattern = i;
+        else
+        {
+            int last = nodes[node].pattern;
+            while (matcher->duplicates[last] != -1)
+                last = matcher->duplicates[last];
+            matcher->duplicates[last] = i;
+        }
+    }
+
+    // Breadth-first pass to link every node to its longest proper suffix
+    // (root's children always fail back to root)
+    int head = 0, tail = 0;
+    int child = nodes[0].child;
+    for (; child != -1; child = nodes[child].sibling)
+    {
+        matcher->rootChildren[nodes[child].c] = child;
+        queue[tail++] = child;
+    }
+
+    while (head < tail)
+    {
+        int node = queue[head++];
+        for (child = nodes[node].child; child != -1;
+            child = nodes[child].sibling)
+        {
+            int fail = nodes[node].fail;
+            while (fail != 0 && findChild(nodes, fail, nodes[child].c) == -1)
+                fail = nodes[fail].fail;
+
+            int next = findChild(nodes, fail, nodes[child].c);
+            nodes[child].fail = next == -1 ? 0 : next;
+
+            fail = nodes[child].fail;
+            nodes[child].output = nodes[fail].pattern != -1 ? fail :
+                nodes[fail].output;
+
+            queue[tail++] = child;
+        }
+    }
+
+    free(queue);
+    return 1;
+}
+
+/**
+ * Frees the memory used by a matcher.
+ * @param matcher Matcher to free
+ */
+void freeMatcher(PATTERN_MATCHER *matcher)
+{
+    free(matcher->nodes);
+    free(matcher->duplicates);
+    free(matcher->rootChildren);
+    matcher->nodes = NULL;
+    matcher->duplicates = NULL;
+    matcher->rootChildren = NULL;
+    matcher->count = 0;
+}
+
+/**
+ * Scans a string once for every pattern in a matcher's table.
+ * @param matcher Matcher to use
+ * @param text Input string to scan
+ * @param minIndex Ignore patterns with a table index lower than this
+ * @return Lowest table index (at least minIndex) of the patterns found in the
+ *         input string; -1 if none were found
+ */
+int matchFirst(const PATTERN_MATCHER *matcher, const char *text,
+    const int minIndex)
+{
+    if (matcher->count == 0 || !text) return -1;
+
+    const MATCHER_NODE *nodes = matcher->nodes;
+    int best = -1;
+    int node = 0;
+
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++)
+    {
+        node = nextNode(matcher, node, *c);
+
+        // Check every pattern ending here
+        int out = nodes[node].pattern != -1 ? node : nodes[node].output;
+        for (; out != -1; out = nodes[out].output)
+        {
+            int pattern = nodes[out].pattern;
+            while (pattern != -1 && pattern < minIndex)
+                pattern = matcher->duplicates[pattern];
+
+            if (pattern != -1 && (best == -1 || pattern < best))
+            {
+                best = pattern;
+                // Nothing can beat this, so no point going further
+                if (best == minIndex) return best;
+            }
+        }
+    }
+
+    return best;
+}
+
+/**
+ * Scans part of a string once for every occurrence of every pattern in a
+ * matcher's table, overlapping or not. Where identical patterns are found,
+ * only the one with the lowest table index is reported.
+ * @param matcher Matcher to use
+ * @param text Input string to scan
+ * @param len Number of bytes of the input string to scan
+ * @param matches Receives the matches found, in order of where they end
+ * @param maxMatches Most matches to store
+ * @return Number of matches found, which may be more than were stored
+ */
+int matchAll(const PATTERN_MATCHER *matcher, const char *text, const int len,
+    PATTERN_MATCH *matches, const int maxMatches)
+{
+    if (matcher->count == 0 || !text) return 0;
+
+    const MATCHER_NODE *nodes = matcher->nodes;
+    int found = 0;
+    int node = 0;
+
+    for (int i = 0; i < len; i++)
+    {
+        node = nextNode(matcher, node, (unsigned char)text[i]);
+
+        int out = nodes[node].pattern != -1 ? node : nodes[node].output;
+        for (; out != -1; out = nodes[out].output)
+        {
+            if (found < maxMatches)
+                matches[found] = (PATTERN_MATCH){ nodes[out].pattern, i + 1 };
+            found++;
+        }
+    }
+
+    return found;
+}
@@ -0,0 +1,61 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to matching a table  ##
+    ## of patterns against a string in a single pass    ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#ifndef MATCHER
+#define MATCHER
+
+typedef struct {
+    // Byte on the edge leading into this node
+    unsigned char c;
+    // First child and next sibling nodes (-1 if none)
+    int child;
+    int sibling;
+    // Node for the longest proper suffix that is also in the trie
+    int fail;
+    // Lowest index of the patterns ending at this node (-1 if none)
+    int pattern;
+    // Nearest node along the fail links that ends a pattern (-1 if none)
+    int output;
+} MATCHER_NODE;
+
+// Aho-Corasick automaton over a table of patterns, where a pattern's index in
+// its table is its priority (lower is higher priority)
+typedef struct {
+    MATCHER_NODE *nodes;
+    int count;
+    // Next higher index of a pattern identical to each one (-1 if none)
+    int *duplicates;
+    // Root's child for every byte (0 if none), as most bytes scanned start
+    // no pattern and would otherwise walk all of root's children
+    int *rootChildren;
+} PATTERN_MATCHER;
+
+// A pattern found in a string
+typedef struct {
+    // Table index of the pattern
+    int pattern;
+    // Offset just past the last byte of the match
+    int end;
+} PATTERN_MATCH;
+
+
+
+int buildMatcher(PATTERN_MATCHER *, const char *const *, const int);
+void freeMatcher(PATTERN_MATCHER *);
+int matchFirst(const PATTERN_MATCHER *, const char *, const int);
+int matchAll(const PATTERN_MATCHER *, const char *, const int,
+    PATTERN_MATCH *, const int);
+
+#endif
@@ -13,8 +13,10 @@
 
 
 
+#include "arena.h"
 #include "general.h"
 #include "globals.h"
+#include "io.h"
 #include "memory.h"
 
 #include <stdlib.h>
@@ -30,7 +32,7 @@ MemInfo getMemInfo(void)
 {
     MemInfo mi = {0};
 
-    FILE *fStream = fopen("/proc/meminfo", "r");
+    FILE *fStream = openFile("/proc/meminfo", "r");
     if (fStream)
     {
         char buffer[128];
@@ -57,22 +59,24 @@ MemInfo getMemInfo(void)
 }
 
 /**
+ * @param arena Arena to allocate the result from
  * @param mi /proc/meminfo data
  * @return String containing the system memory used and total amounts both
- *         numerically and as a percentage
+ *         numerically and as a percentage; NULL if out of memory
  */
-char *getRAM(MemInfo mi)
+char *getRAM(MEM_ARENA *arena, MemInfo mi)
 {
     const int ramSize = 64;
-    char *ram = malloc(ramSize);
+    char *ram = arenaAlloc(arena, ramSize);
     if (!ram)
-        return strdup("");
+        return NULL;
     ram[0] = '\0';
 
     long freeMem = mi.memFree + mi.buffers + mi.cached;
     long used = mi.memTotal - freeMem;
-    char *usedStr = bytesToReadable("KiB", used);
-    char *totalStr = bytesToReadable("KiB", mi.memTotal);
+    char usedStr[READABLE_LEN], totalStr[READABLE_LEN];
+    bytesToReadableInto(usedStr, READABLE_LEN, "KiB", used);
+    bytesToReadableInto(totalStr, READABLE_LEN, "KiB", mi.memTotal);
 
     if (!COMPACT)
     {
@@ -80,32 +84,31 @@ char *getRAM(MemInfo mi)
         snprintf(ram, ramSize, "%s / %s (%d%%)", usedStr, totalStr, pct);
     }
     else snprintf(ram, ramSize, "%s / %s", usedStr, totalStr);
-    
-    free(usedStr);
-    free(totalStr);
 
     return ram;
 }
 
 /**
+ * @param arena Arena to allocate the result from
  * @param mi /proc/meminfo data
  * @return String containing the system swap used and total amounts both
- *         numerically and as a percentage
+ *         numerically and as a percentage; NULL if out of memory
  */
-char *getSwap(MemInfo mi)
+char *getSwap(MEM_ARENA *arena, MemInfo mi)
 {
     if (mi.swapTotal == 0)
-        return strdup("");
+        return arenaStrdup(arena, "");
 
     const int swapSize = 64;
-    char *swap = malloc(swapSize);
+    char *swap = arenaAlloc(arena, swapSize);
     if (!swap)
-        return strdup("");
+        return NULL;
     swap[0] = '\0';
 
     long used = mi.swapTotal - mi.swapFree;
-    char *usedStr = bytesToReadable("KiB", used);
-    char *totalStr = bytesToReadable("KiB", mi.swapTotal);
+    char usedStr[READABLE_LEN], totalStr[READABLE_LEN];
+    bytesToReadableInto(usedStr, READABLE_LEN, "KiB", used);
+    bytesToReadableInto(totalStr, READABLE_LEN, "KiB", mi.swapTotal);
 
     if (!COMPACT)
     {
@@ -114,8 +117,5 @@ char *getSwap(MemInfo mi)
     }
     else snprintf(swap, swapSize, "%s / %s", usedStr, totalStr);
 
-    free(usedStr);
-    free(totalStr);
-
     return swap;
 }
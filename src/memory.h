@@ -16,6 +16,9 @@
 #ifndef MEMORY
 #define MEMORY
 
+#include "arena.h"
+
+
 typedef struct {
     long memTotal;
     long memFree;
@@ -28,7 +31,7 @@ typedef struct {
 
 
 MemInfo getMemInfo(void);
-char *getRAM(MemInfo mi);
-char *getSwap(MemInfo mi);
+char *getRAM(MEM_ARENA *, MemInfo mi);
+char *getSwap(MEM_ARENA *, MemInfo mi);
 
 #endif
@@ -13,10 +13,12 @@
 
 
 
+#include "arena.h"
 #include "general.h"
 #include "globals.h"
+#include "io.h"
 #ifndef NO_STR_CLEANING
-#include "replacements.h"
+#include "replacer.h"
 #endif
 #include "os.h"
 
@@ -26,21 +28,22 @@
 
 
 /**
+ * @param arena Arena to allocate the result from
  * @param u Parsed uname data
  * @param uStatus The status returned from uname attempt
  * @return String containing the OS/Linux distro's name or "unknown" if
- *         undetermined/error
+ *         undetermined/error; NULL if out of memory
  */
-char *getOS(struct utsname u, int uStatus)
+char *getOS(MEM_ARENA *arena, struct utsname u, int uStatus)
 {
     const int osSize = 128;
-    char *os = malloc(osSize);
+    char *os = arenaAlloc(arena, osSize);
     if (!os)
-        return strdup("unknown");
+        return NULL;
     os[0] = '\0';
 
     // Try os-release
-    FILE *fStream = fopen("/etc/os-release", "r");
+    FILE *fStream = openFile("/etc/os-release", "r");
     if (fStream)
     {
         char buffer[128];
@@ -48,9 +51,7 @@ char *getOS(struct utsname u, int uStatus)
         {
             if (strncmp(buffer, "PRETTY_NAME=", 12) == 0)
             {
-                char *extract = extractFromPoint(buffer, osSize, '=');
-                strncpy(os, extract, osSize - 1);
-                free(extract);
+                extractFromPointInto(buffer, '=', os, osSize);
                 break;
             }
         }
@@ -60,7 +61,7 @@ char *getOS(struct utsname u, int uStatus)
     // Try issue
     if (os[0] == '\0')
     {
-        fStream = fopen("/etc/issue", "r");
+        fStream = openFile("/etc/issue", "r");
         if (fStream)
         {
             char buffer[osSize];
@@ -117,22 +118,7 @@ char *getOS(struct utsname u, int uStatus)
 
 #ifndef NO_STR_CLEANING
 
-        int replaces = 0;
-        for (int i = 0; i < COMPACT_OS_REPLACES_LEN; i++)
-        {
-            if (COMPACT_OS_REPLACES[i].standalone && replaces > 0)
-                continue;
-            else if (strstr(os, COMPACT_OS_REPLACES[i].match))
-            {
-                char *tmp = findReplace(os, osSize,
-                    COMPACT_OS_REPLACES[i].match,
-                    COMPACT_OS_REPLACES[i].replacement);
-                strncpy(os, tmp, osSize - 1);
-                os[osSize - 1] = '\0';
-                free(tmp);
-                replaces++;
-            }
-        }
+        replaceAll(getReplacer(REPLACER_COMPACT_OS), os, os, osSize);
 
 #endif
 
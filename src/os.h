@@ -16,10 +16,12 @@
 #ifndef OS
 #define OS
 
+#include "arena.h"
+
 #include <sys/utsname.h>
 
 
 
-char *getOS(struct utsname, int);
+char *getOS(MEM_ARENA *, struct utsname, int);
 
 #endif
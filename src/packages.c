@@ -13,8 +13,10 @@
 
 
 
+#include "arena.h"
 #include "general.h"
 #include "globals.h"
+#include "io.h"
 #include "packages.h"
 
 #include <dirent.h>
@@ -30,14 +32,14 @@
  * @return String containing counts of various packages including dpkg,
  *         pacman, rpm, flatpak and snap.
  */
-char *getPackages(const char *os)
+char *getPackages(MEM_ARENA *arena, const char *os)
 {
     // We know for sure SHORK doesn't have a package manager...
     if (os && strncmp(os, "SHORK", 5) == 0)
         return NULL;
 
     const int PKGS_SIZE = 256;
-    char *pkgs = malloc(PKGS_SIZE);
+    char *pkgs = arenaAlloc(arena, PKGS_SIZE);
     if (!pkgs) return NULL;
     pkgs[0] = '\0';
 
@@ -48,7 +50,7 @@ char *getPackages(const char *os)
     int sCount = 0;
 
     // Get Debian-style packages by counting inside /var/lib/dpkg/status
-    FILE *dpkgStatus = fopen("/var/lib/dpkg/status", "r");
+    FILE *dpkgStatus = openFile("/var/lib/dpkg/status", "r");
     if (dpkgStatus)
     {
         const char *needle = "Status: install ok installed";
@@ -61,7 +63,7 @@ char *getPackages(const char *os)
     }
 
     // Get Arch-style packages by counting inside /var/lib/pacman/local
-    DIR *pacmanLocal = opendir("/var/lib/pacman/local");
+    DIR *pacmanLocal = openDir("/var/lib/pacman/local");
     if (pacmanLocal)
     {
         struct dirent *dirEntry;
@@ -76,7 +78,7 @@ char *getPackages(const char *os)
     if (isProgramInstalled("rpm", 0))
     {
         // Try rpm for now (it's slow, we should find a better way...)
-        FILE *fStream = popen("rpm -qa 2>/dev/null | wc -l", "r");
+        FILE *fStream = openProgram("rpm -qa 2>/dev/null | wc -l");
         if (fStream)
         {
             fscanf(fStream, "%d", &rCount);
@@ -109,7 +111,7 @@ char *getPackages(const char *os)
         //              /name            /arch  /branch/BINGO
         for (int i = 0; i < 4; i++)
         {
-            DIR *flatpakDir = opendir(flatpakDirs[i]);
+            DIR *flatpakDir = openDir(flatpakDirs[i]);
             if (!flatpakDir)
                 continue;
             int currFlatpakDirLen = strlen(flatpakDirs[i]);
@@ -127,7 +129,7 @@ char *getPackages(const char *os)
                 if (archPathLen < 0 ||
                     archPathLen >= PATH_MAX - currFlatpakDirLen)
                     continue;
-                DIR *archDir = opendir(archPath);
+                DIR *archDir = openDir(archPath);
                 if (!archDir)
                     continue;
 
@@ -144,7 +146,7 @@ char *getPackages(const char *os)
                     if (branchPathLen < 0 ||
                         branchPathLen >= PATH_MAX - archPathLen)
                         continue;
-                    DIR *branchDir = opendir(branchPath);
+                    DIR *branchDir = openDir(branchPath);
                     if (!branchDir)
                         continue;
 
@@ -162,7 +164,7 @@ char *getPackages(const char *os)
                         if (activePathLen < 0 ||
                             activePathLen >= PATH_MAX - branchPathLen)
                             continue;
-                        if (access(activePath, F_OK) != 0)
+                        if (accessPath(activePath, F_OK) != 0)
                             continue;
 
                         // flatpak list seems to skip .Locale, so we do so
@@ -187,7 +189,7 @@ char *getPackages(const char *os)
     const char *snapDirs[] = {"/snap", "/var/lib/snapd/snap"};
     for (int i = 0; i < 2; i++)
     {
-        DIR *snapDir = opendir(snapDirs[i]);
+        DIR *snapDir = openDir(snapDirs[i]);
         if (!snapDir)
             continue;
 
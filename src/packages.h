@@ -16,6 +16,10 @@
 #ifndef PACKAGES
 #define PACKAGES
 
-char *getPackages(const char*);
+#include "arena.h"
+
+
+
+char *getPackages(MEM_ARENA *, const char*);
 
 #endif
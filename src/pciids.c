@@ -0,0 +1,495 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to looking up names  ##
+    ## in the PCI IDs database via a binary index       ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#include "cache.h"
+#include "io.h"
+#include "pciids.h"
+
+#include <fcntl.h>
+#include <linux/limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+
+typedef struct {
+    // Whole index as laid out in its file; NULL if none is loaded
+    char *data;
+    size_t dataLen;
+    // Flags if the data is a mapping of an index file instead of built here
+    int mapped;
+    const PCIIDS_HEADER *header;
+    const char *path;
+    const PCIIDS_VENDOR *vendors;
+    const PCIIDS_DEVICE *devices;
+    const char *names;
+    // pci.ids itself, for reading device names; -1 if not open
+    int fd;
+} PCIIDS_INDEX;
+
+
+
+// Index of the pci.ids last looked up in
+static PCIIDS_INDEX INDEX = { NULL, 0, 0, NULL, NULL, NULL, NULL, NULL, -1 };
+// Guards the index, as the GPU collector may run on a worker thread
+static pthread_mutex_t INDEX_LOCK = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+/**
+ * Compares two vendor or device table entries by ID (both start with it).
+ */
+static int compareIDs(const void *a, const void *b)
+{
+    uint32_t idA = *(const uint32_t *)a;
+    uint32_t idB = *(const uint32_t *)b;
+    return (idA > idB) - (idA < idB);
+}
+
+/**
+ * @param pathLen Length of the indexed path (including the terminator)
+ * @return Space the path takes up in an index file
+ */
+static size_t getPathSpan(const uint32_t pathLen)
+{
+    return (pathLen + 7) & ~(size_t)7;
+}
+
+/**
+ * Checks if an index was made from a pci.ids as it is now.
+ * @param index Index to check
+ * @param path Path to pci.ids
+ * @param st pci.ids' current status
+ * @return 1 if the index is up-to-date; 0 if not
+ */
+static int isIndexOf(const PCIIDS_INDEX *index, const char *path,
+    const struct stat *st)
+{
+    return index->header->size == (int64_t)st->st_size &&
+        index->header->mtimeSec == (int64_t)st->st_mtim.tv_sec &&
+        index->header->mtimeNsec == (int64_t)st->st_mtim.tv_nsec &&
+        strcmp(index->path, path) == 0;
+}
+
+/**
+ * Parses the ID at the start of a vendor or device line of pci.ids, which is
+ * four lowercase hex digits followed by two spaces.
+ * @param str Start of the ID
+ * @param id Receives the ID
+ * @return 1 if there is an ID; 0 if not
+ */
+static int parseID(const char *str, uint32_t *id)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        int digit;
+        if (str[i] >= '0' && str[i] <= '9')
+            digit = str[i] - '0';
+        else if (str[i] >= 'a' && str[i] <= 'f')
+            digit = str[i] - 'a' + 10;
+        else
+            return 0;
+        value = (value << 4) | digit;
+    }
+    if (str[4] != ' ' || str[5] != ' ')
+        return 0;
+
+    *id = value;
+    return 1;
+}
+
+/**
+ * Makes sure an array has room for a number of items, growing it if not.
+ * @param array Array to grow
+ * @param cap Number of items the array has room for
+ * @param need Number of items needed
+ * @param size Size of an item
+ * @return 1 if there is room; 0 if out of memory
+ */
+static int reserve(void **array, size_t *cap, const size_t need,
+    const size_t size)
+{
+    if (need <= *cap) return 1;
+
+    size_t newCap = *cap ? *cap * 2 : 256;
+    while (newCap < need) newCap *= 2;
+    void *grown = realloc(*array, newCap * size);
+    if (!grown) return 0;
+
+    *array = grown;
+    *cap = newCap;
+    return 1;
+}
+
+/**
+ * Points an index's tables into its data, checking that they fit.
+ * @param index Index to set up
+ * @return 1 if the data holds a whole index; 0 if not
+ */
+static int setTables(PCIIDS_INDEX *index)
+{
+    if (index->dataLen < sizeof(PCIIDS_HEADER)) return 0;
+
+    const PCIIDS_HEADER *header = (const PCIIDS_HEADER *)index->data;
+    if (memcmp(header->magic, PCIIDS_MAGIC, 4) != 0 ||
+        header->format != PCIIDS_FORMAT || header->pathLen == 0)
+        return 0;
+
+    size_t vendorsAt = sizeof(PCIIDS_HEADER) + getPathSpan(header->pathLen);
+    size_t devicesAt = vendorsAt +
+        (size_t)header->vendorsLen * sizeof(PCIIDS_VENDOR);
+    size_t namesAt = devicesAt +
+        (size_t)header->devicesLen * sizeof(PCIIDS_DEVICE);
+    if (namesAt + header->namesLen != index->dataLen) return 0;
+
+    index->header = header;
+    index->path = index->data + sizeof(PCIIDS_HEADER);
+    index->vendors = (const PCIIDS_VENDOR *)(index->data + vendorsAt);
+    index->devices = (const PCIIDS_DEVICE *)(index->data + devicesAt);
+    index->names = index->data + namesAt;
+
+    // Strings must be terminated, so they can never be read past
+    return index->path[header->pathLen - 1] == '\0' &&
+        (header->namesLen == 0 ||
+        index->names[header->namesLen - 1] == '\0');
+}
+
+/**
+ * Frees an index and closes its pci.ids.
+ * @param index Index to unload
+ */
+static void unloadIndex(PCIIDS_INDEX *index)
+{
+    if (index->data)
+    {
+        if (index->mapped)
+            munmap(index->data, index->dataLen);
+        else
+            free(index->data);
+    }
+    if (index->fd != -1)
+        close(index->fd);
+
+    memset(index, 0, sizeof(PCIIDS_INDEX));
+    index->fd = -1;
+}
+
+/**
+ * Builds an index of pci.ids in memory, from a single pass over it.
+ * @param index Receives the index
+ * @param fd pci.ids, freshly opened (left open)
+ * @param path Path to pci.ids
+ * @param st pci.ids' current status
+ * @return 1 if built; 0 if pci.ids could not be read or out of memory
+ */
+static int buildIndex(PCIIDS_INDEX *index, const int fd, const char *path,
+    const struct stat *st)
+{
+    // Read through a duplicate, so the index is of the very pci.ids that the
+    // names are later read from
+    int streamFD = dup(fd);
+    FILE *fStream = streamFD != -1 ? fdopen(streamFD, "r") : NULL;
+    if (!fStream)
+    {
+        if (streamFD != -1) close(streamFD);
+        return 0;
+    }
+
+    PCIIDS_VENDOR *vendors = NULL;
+    size_t vendorsLen = 0, vendorsCap = 0;
+    PCIIDS_DEVICE *devices = NULL;
+    size_t devicesLen = 0, devicesCap = 0;
+    char *names = NULL;
+    size_t namesLen = 0, namesCap = 0;
+    int ok = 1;
+
+    char *line = NULL;
+    size_t lineCap = 0;
+    ssize_t lineLen;
+    size_t offset = 0;
+    while (ok && (lineLen = getline(&line, &lineCap, fStream)) != -1)
+    {
+        size_t lineOffset = offset;
+        offset += lineLen;
+
+        // Device classes come after every vendor, and we have no use for them
+        if (line[0] == 'C' && line[1] == ' ')
+            break;
+
+        uint32_t id;
+        if (parseID(line, &id))
+        {
+            char *name = line + 6;
+            size_t nameLen = strcspn(name, "\n");
+            ok = reserve((void **)&vendors, &vendorsCap, vendorsLen + 1,
+                sizeof(PCIIDS_VENDOR)) &&
+                reserve((void **)&names, &namesCap, namesLen + nameLen + 1, 1);
+            if (!ok) break;
+
+            vendors[vendorsLen].id = id;
+            vendors[vendorsLen].name = namesLen;
+            vendors[vendorsLen].firstDevice = devicesLen;
+            vendors[vendorsLen].devicesLen = 0;
+            vendorsLen++;
+            memcpy(names + namesLen, name, nameLen);
+            names[namesLen + nameLen] = '\0';
+            namesLen += nameLen + 1;
+        }
+        // Devices are indented by one tab (subsystems by two, so not matched)
+        else if (line[0] == '\t' && vendorsLen > 0 && parseID(line + 1, &id))
+        {
+            ok = lineOffset + 7 <= UINT32_MAX &&
+                reserve((void **)&devices, &devicesCap, devicesLen + 1,
+                sizeof(PCIIDS_DEVICE));
+            if (!ok) break;
+
+            devices[devicesLen].id = id;
+            devices[devicesLen].name = lineOffset + 7;
+            devicesLen++;
+            vendors[vendorsLen - 1].devicesLen++;
+        }
+    }
+    free(line);
+    fclose(fStream);
+
+    // pci.ids is kept sorted, but nothing makes it so
+    if (ok)
+    {
+        for (size_t i = 0; i < vendorsLen; i++)
+            qsort(devices + vendors[i].firstDevice, vendors[i].devicesLen,
+                sizeof(PCIIDS_DEVICE), compareIDs);
+        qsort(vendors, vendorsLen, sizeof(PCIIDS_VENDOR), compareIDs);
+    }
+
+    // Lay the index out the same as its file, so it is used the same way
+    size_t pathLen = strlen(path) + 1;
+    size_t vendorsAt = sizeof(PCIIDS_HEADER) + getPathSpan(pathLen);
+    size_t devicesAt = vendorsAt + vendorsLen * sizeof(PCIIDS_VENDOR);
+    size_t namesAt = devicesAt + devicesLen * sizeof(PCIIDS_DEVICE);
+    char *data = ok ? calloc(1, namesAt + namesLen) : NULL;
+    if (data)
+    {
+        PCIIDS_HEADER *header = (PCIIDS_HEADER *)data;
+        memcpy(header->magic, PCIIDS_MAGIC, 4);
+        header->format = PCIIDS_FORMAT;
+        header->size = st->st_size;
+        header->mtimeSec = st->st_mtim.tv_sec;
+        header->mtimeNsec = st->st_mtim.tv_nsec;
+        header->pathLen = pathLen;
+        header->vendorsLen = vendorsLen;
+        header->devicesLen = devicesLen;
+        header->namesLen = namesLen;
+        memcpy(data + sizeof(PCIIDS_HEADER), path, pathLen);
+        if (vendorsLen)
+            memcpy(data + vendorsAt, vendors,
+                vendorsLen * sizeof(PCIIDS_VENDOR));
+        if (devicesLen)
+            memcpy(data + devicesAt, devices,
+                devicesLen * sizeof(PCIIDS_DEVICE));
+        if (namesLen)
+            memcpy(data + namesAt, names, namesLen);
+
+        index->data = data;
+        index->dataLen = namesAt + namesLen;
+        index->mapped = 0;
+        setTables(index);
+    }
+
+    free(vendors);
+    free(devices);
+    free(names);
+    return data != NULL;
+}
+
+/**
+ * Loads a previously saved index of pci.ids, if it is still up-to-date.
+ * @param index Receives the index
+ * @param path Path to pci.ids
+ * @param st pci.ids' current status
+ * @return 1 if loaded; 0 if there is no saved index or it is out-of-date
+ */
+static int loadIndex(PCIIDS_INDEX *index, const char *path,
+    const struct stat *st)
+{
+    char *dir = getCacheDir();
+    if (!dir) return 0;
+    char indexPath[PATH_MAX + 16];
+    snprintf(indexPath, sizeof(indexPath), "%s%s", dir, PCIIDS_INDEX_NAME);
+    free(dir);
+
+    int fd = open(indexPath, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return 0;
+
+    struct stat indexSt;
+    if (fstat(fd, &indexSt) != 0 ||
+        indexSt.st_size < (off_t)sizeof(PCIIDS_HEADER))
+    {
+        close(fd);
+        return 0;
+    }
+
+    // Mapped, so only the parts the lookups touch are ever read
+    void *data = mmap(NULL, indexSt.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return 0;
+
+    index->data = data;
+    index->dataLen = indexSt.st_size;
+    index->mapped = 1;
+    if (!setTables(index) || !isIndexOf(index, path, st))
+    {
+        unloadIndex(index);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Saves an index to our cache directory, for later runs to load.
+ * @param index Index to save
+ */
+static void saveIndex(const PCIIDS_INDEX *index)
+{
+    char *dir = makeCacheDir();
+    if (!dir) return;
+
+    // Write to a temporary file first, so a concurrent run never maps a
+    // half-written index
+    char tmpPath[PATH_MAX + 32];
+    char finalPath[PATH_MAX + 16];
+    snprintf(tmpPath, sizeof(tmpPath), "%s%s.%d", dir, PCIIDS_INDEX_NAME,
+        (int)getpid());
+    snprintf(finalPath, sizeof(finalPath), "%s%s", dir, PCIIDS_INDEX_NAME);
+    free(dir);
+
+    FILE *file = fopen(tmpPath, "w");
+    if (!file) return;
+
+    int ok = fwrite(index->data, 1, index->dataLen, file) == index->dataLen;
+    if (fclose(file) == 0 && ok)
+        rename(tmpPath, finalPath);
+    else
+        remove(tmpPath);
+}
+
+/**
+ * Makes sure the index is of a pci.ids as it is now, loading, or building and
+ * saving, a new one if not, and that the pci.ids open for reading names from
+ * is the one it was made of.
+ * @param path Path to pci.ids
+ * @return 1 if the index is ready; 0 if pci.ids could not be indexed
+ */
+static int useIndex(const char *path)
+{
+    struct stat st;
+    if (statPath(path, &st) != 0) return 0;
+    if (INDEX.data && INDEX.fd != -1 && isIndexOf(&INDEX, path, &st)) return 1;
+
+    // pci.ids may be replaced at any time, so what is actually opened is what
+    // the index is checked against (or built from), not what was stat'ed
+    int fd = openFileAt(AT_FDCWD, path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return 0;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return 0;
+    }
+
+    if (!INDEX.data || !isIndexOf(&INDEX, path, &st))
+    {
+        unloadIndex(&INDEX);
+        // A sysroot's pci.ids is not this system's, so its index is never kept
+        if (getSysroot() || !loadIndex(&INDEX, path, &st))
+        {
+            if (!buildIndex(&INDEX, fd, path, &st))
+            {
+                close(fd);
+                return 0;
+            }
+            if (!getSysroot()) saveIndex(&INDEX);
+        }
+    }
+
+    if (INDEX.fd != -1) close(INDEX.fd);
+    INDEX.fd = fd;
+    return 1;
+}
+
+
+
+/**
+ * Frees the index and closes its pci.ids.
+ */
+void freePCIIDs(void)
+{
+    pthread_mutex_lock(&INDEX_LOCK);
+    unloadIndex(&INDEX);
+    pthread_mutex_unlock(&INDEX_LOCK);
+}
+
+/**
+ * Looks up a vendor's and device's names in the PCI IDs database. This takes
+ * two binary searches of the index and a single read of pci.ids.
+ * @param path Path to pci.ids
+ * @param vendor Vendor ID
+ * @param device Device ID
+ * @param vendorName Receives the vendor's name
+ * @param deviceName Receives the device's name
+ * @param nameLen Size of both name buffers
+ * @return 1 if both were found; 0 if not
+ */
+int lookupPCIIDs(const char *path, const int vendor, const int device,
+    char *vendorName, char *deviceName, const int nameLen)
+{
+    int found = 0;
+
+    pthread_mutex_lock(&INDEX_LOCK);
+    if (useIndex(path))
+    {
+        uint32_t key = vendor;
+        const PCIIDS_VENDOR *v = bsearch(&key, INDEX.vendors,
+            INDEX.header->vendorsLen, sizeof(PCIIDS_VENDOR), compareIDs);
+        const PCIIDS_DEVICE *d = NULL;
+        if (v && v->name < INDEX.header->namesLen &&
+            v->firstDevice <= INDEX.header->devicesLen &&
+            v->devicesLen <= INDEX.header->devicesLen - v->firstDevice)
+        {
+            key = device;
+            d = bsearch(&key, INDEX.devices + v->firstDevice, v->devicesLen,
+                sizeof(PCIIDS_DEVICE), compareIDs);
+        }
+
+        if (d)
+        {
+            ssize_t len = pread(INDEX.fd, deviceName, nameLen - 1, d->name);
+            if (len > 0)
+            {
+                deviceName[len] = '\0';
+                deviceName[strcspn(deviceName, "\n")] = '\0';
+                snprintf(vendorName, nameLen, "%s", INDEX.names + v->name);
+                found = 1;
+            }
+        }
+    }
+    pthread_mutex_unlock(&INDEX_LOCK);
+
+    return found;
+}
@@ -0,0 +1,71 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to looking up names  ##
+    ## in the PCI IDs database via a binary index       ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#ifndef PCIIDS
+#define PCIIDS
+
+#include <stdint.h>
+
+
+
+// Bump whenever the index's layout changes, so old index files are rebuilt
+#define PCIIDS_FORMAT       1
+#define PCIIDS_MAGIC        "SFPI"
+#define PCIIDS_INDEX_NAME   "pciids.index"
+// Longest name that will be read from pci.ids (including the terminator)
+#define PCIIDS_NAME_LEN     256
+
+
+
+// An index file is laid out as the header, the path to the pci.ids it indexes
+// (padded to 8 bytes), the vendor table, the device table and the vendor
+// names. Both tables are sorted by ID, with each vendor's devices forming one
+// run of the device table. Device names stay in pci.ids and are read straight
+// from there, so the index stays small.
+typedef struct {
+    char magic[4];
+    uint32_t format;
+    // State of pci.ids when it was indexed
+    int64_t size;
+    int64_t mtimeSec;
+    int64_t mtimeNsec;
+    uint32_t pathLen;
+    uint32_t vendorsLen;
+    uint32_t devicesLen;
+    uint32_t namesLen;
+} PCIIDS_HEADER;
+
+typedef struct {
+    uint32_t id;
+    // Offset of the name in the vendor names
+    uint32_t name;
+    // Run of the device table holding the vendor's devices
+    uint32_t firstDevice;
+    uint32_t devicesLen;
+} PCIIDS_VENDOR;
+
+typedef struct {
+    uint32_t id;
+    // Offset of the name in pci.ids
+    uint32_t name;
+} PCIIDS_DEVICE;
+
+
+
+void freePCIIDs(void);
+int lookupPCIIDs(const char *, const int, const int, char *, char *,
+    const int);
+
+#endif
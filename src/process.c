@@ -0,0 +1,188 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to taking and        ##
+    ## querying a snapshot of the running processes     ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#include "io.h"
+#include "process.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+
+// The one snapshot shared by every process lookup during a run
+static PROC_TABLE PROCS = { NULL, -1 };
+// Guards taking the snapshot, as lookups may come from collector threads
+static pthread_mutex_t PROCS_LOCK = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+/**
+ * Orders two process table entries by ascending PID.
+ */
+static int procCmp(const void *a, const void *b)
+{
+    const PROC_ENTRY *pa = (const PROC_ENTRY *)a;
+    const PROC_ENTRY *pb = (const PROC_ENTRY *)b;
+    return (pa->pid > pb->pid) - (pa->pid < pb->pid);
+}
+
+/**
+ * Fills a process table entry from the contents of a /proc/<pid>/stat file.
+ * @param stat Contents of the stat file
+ * @param entry Entry to fill
+ * @return 1 if successful; 0 if the contents could not be understood
+ */
+static int parseProcStat(char *stat, PROC_ENTRY *entry)
+{
+    // comm is wrapped in brackets and may contain spaces or brackets itself,
+    // so the last closing bracket marks its end
+    char *commStart = strchr(stat, '(');
+    char *commEnd = strrchr(stat, ')');
+    if (!commStart || !commEnd || commEnd < commStart) return 0;
+
+    int commLen = commEnd - commStart - 1;
+    if (commLen >= TASK_COMM_LEN) commLen = TASK_COMM_LEN - 1;
+    memcpy(entry->comm, commStart + 1, commLen);
+    entry->comm[commLen] = '\0';
+
+    // Following comm: state, PPID, process group, session
+    char state;
+    int pgrp;
+    if (sscanf(commEnd + 1, " %c %d %d %d", &state, &entry->ppid, &pgrp,
+        &entry->sid) != 4)
+        return 0;
+
+    return 1;
+}
+
+/**
+ * Takes a snapshot of every running process with a single pass over /proc.
+ * Each process costs one read of its stat file, rather than separate reads
+ * of comm and status files for every lookup made.
+ */
+static void buildProcTable(void)
+{
+    PROCS.procs = NULL;
+    PROCS.count = 0;
+
+    DIR *proc = openDir("/proc");
+    if (!proc) return;
+
+    int procFd = dirfd(proc);
+    int size = PROC_TABLE_INITIAL_LEN;
+    int sorted = 1;
+    PROCS.procs = malloc(size * sizeof(PROC_ENTRY));
+    if (!PROCS.procs)
+    {
+        closedir(proc);
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(proc)) != NULL)
+    {
+        // Skip non-numeric (not PID) entries
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9')
+            continue;
+
+        char statPath[NAME_MAX + 6];
+        snprintf(statPath, sizeof(statPath), "%s/stat", entry->d_name);
+        int statFd = openFileAt(procFd, statPath, O_RDONLY);
+        if (statFd < 0) continue;
+
+        char buffer[PROC_STAT_BUFFER_LEN];
+        ssize_t bytes = read(statFd, buffer, sizeof(buffer) - 1);
+        close(statFd);
+        if (bytes <= 0) continue;
+        buffer[bytes] = '\0';
+
+        if (PROCS.count == size)
+        {
+            size *= 2;
+            PROC_ENTRY *grown = realloc(PROCS.procs,
+                size * sizeof(PROC_ENTRY));
+            if (!grown) break;
+            PROCS.procs = grown;
+        }
+
+        PROC_ENTRY *curr = &PROCS.procs[PROCS.count];
+        curr->pid = atoi(entry->d_name);
+        if (!parseProcStat(buffer, curr)) continue;
+
+        // The owner of a process' /proc directory is its real UID
+        struct stat st;
+        if (fstatat(procFd, entry->d_name, &st, 0) == 0)
+            curr->uid = (int)st.st_uid;
+        else
+            curr->uid = -1;
+
+        if (PROCS.count > 0 && PROCS.procs[PROCS.count - 1].pid > curr->pid)
+            sorted = 0;
+        PROCS.count++;
+    }
+
+    closedir(proc);
+
+    // /proc is normally listed in PID order already, but lookups rely on it
+    if (!sorted)
+        qsort(PROCS.procs, PROCS.count, sizeof(PROC_ENTRY), procCmp);
+}
+
+
+
+/**
+ * Finds a given process ID (PID) in the process table snapshot.
+ * @param pid The input PID
+ * @return Pointer to the process' table entry; NULL if not found
+ */
+const PROC_ENTRY *findProc(int pid)
+{
+    const PROC_TABLE *table = getProcTable();
+    if (!table->procs) return NULL;
+
+    PROC_ENTRY key;
+    key.pid = pid;
+    return bsearch(&key, table->procs, table->count, sizeof(PROC_ENTRY),
+        procCmp);
+}
+
+/**
+ * Frees the process table snapshot. A later lookup will take a new one.
+ */
+void freeProcTable(void)
+{
+    free(PROCS.procs);
+    PROCS.procs = NULL;
+    PROCS.count = -1;
+}
+
+/**
+ * @return Snapshot of the running processes, sorted by PID. It is taken on
+ *         first use and shared by every lookup thereafter
+ */
+const PROC_TABLE *getProcTable(void)
+{
+    pthread_mutex_lock(&PROCS_LOCK);
+    if (PROCS.count == -1)
+        buildProcTable();
+    pthread_mutex_unlock(&PROCS_LOCK);
+    return &PROCS;
+}
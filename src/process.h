@@ -0,0 +1,47 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to taking and        ##
+    ## querying a snapshot of the running processes     ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#ifndef PROCESS_TABLE
+#define PROCESS_TABLE
+
+#include "general.h"
+
+
+
+typedef struct {
+    int pid;
+    int ppid;
+    int uid;
+    int sid;
+    char comm[TASK_COMM_LEN];
+} PROC_ENTRY;
+
+typedef struct {
+    PROC_ENTRY *procs;
+    int count;
+} PROC_TABLE;
+
+
+
+#define PROC_TABLE_INITIAL_LEN  256
+#define PROC_STAT_BUFFER_LEN    512
+
+
+
+const PROC_ENTRY *findProc(int);
+void freeProcTable(void);
+const PROC_TABLE *getProcTable(void);
+
+#endif
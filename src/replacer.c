@@ -0,0 +1,394 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to rewriting a       ##
+    ## string with a table of replacements in a single  ##
+    ## pass                                             ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#include "replacer.h"
+#ifndef NO_STR_CLEANING
+#include "replacements.h"
+#endif
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+// A match waiting to be replaced
+typedef struct {
+    int pattern;
+    int start;
+    int end;
+} REPLACER_SPAN;
+
+// A string part way through being rewritten by a replacer
+typedef struct {
+    const PATTERN_REPLACER *replacer;
+    char *text;
+    int len;
+    int size;
+    // Matches to replace, in table order, then left to right
+    REPLACER_SPAN pending[REPLACER_MAX_MATCHES];
+    int noPending;
+    // Table index of the last pattern replaced, and the lowest replaced
+    int current;
+    int lowest;
+} REPLACER_STATE;
+
+
+
+#ifndef NO_STR_CLEANING
+
+// Every table in replacements.h, compiled the first time any is needed
+static PATTERN_REPLACER REPLACERS[REPLACER_TABLES_LEN];
+static pthread_once_t REPLACERS_ONCE = PTHREAD_ONCE_INIT;
+
+#endif
+
+
+
+/**
+ * @param a First span
+ * @param b Second span
+ * @return 1 if the first span would be replaced before the second; 0 if not
+ */
+static int isSpanBefore(const REPLACER_SPAN *a, const REPLACER_SPAN *b)
+{
+    return a->pattern < b->pattern ||
+        (a->pattern == b->pattern && a->start < b->start);
+}
+
+static void considerWindow(REPLACER_STATE *, int, int);
+
+/**
+ * Adds a match to those waiting to be replaced if replacing every pattern in
+ * turn would get to it: it must not be blocked by a waiting match replaced
+ * before it, and any waiting matches it overlaps that would be replaced
+ * after it are dropped (and the text they covered looked at again).
+ * @param state String being rewritten
+ * @param span Match to add
+ */
+static void considerSpan(REPLACER_STATE *state, const REPLACER_SPAN span)
+{
+    // Standalone patterns are skipped if any pattern before them is replaced
+    if (state->replacer->entries[span.pattern].standalone &&
+        (state->lowest < span.pattern || (state->noPending > 0 &&
+        state->pending[0].pattern < span.pattern)))
+        return;
+
+    for (int i = 0; i < state->noPending; i++)
+    {
+        const REPLACER_SPAN *other = &state->pending[i];
+        if (span.start < other->end && span.end > other->start &&
+            !isSpanBefore(&span, other))
+            return;
+    }
+
+    REPLACER_SPAN dropped[REPLACER_MAX_MATCHES];
+    int noDropped = 0, kept = 0;
+    for (int i = 0; i < state->noPending; i++)
+    {
+        REPLACER_SPAN other = state->pending[i];
+        if (span.start < other.end && span.end > other.start)
+            dropped[noDropped++] = other;
+        else
+            state->pending[kept++] = other;
+    }
+    state->noPending = kept;
+
+    if (state->noPending < REPLACER_MAX_MATCHES)
+    {
+        int at = state->noPending;
+        while (at > 0 && isSpanBefore(&span, &state->pending[at - 1]))
+        {
+            state->pending[at] = state->pending[at - 1];
+            at--;
+        }
+        state->pending[at] = span;
+        state->noPending++;
+    }
+
+    // Matches that the dropped ones were blocking may now be replaced
+    for (int i = 0; i < noDropped; i++)
+        considerWindow(state, dropped[i].start, dropped[i].end);
+}
+
+/**
+ * Finds the matches in and around part of the string for patterns after the
+ * last one replaced, and considers each for replacing.
+ * @param state String being rewritten
+ * @param from Offset of the first byte changed
+ * @param to Offset just past the last byte changed
+ */
+static void considerWindow(REPLACER_STATE *state, int from, int to)
+{
+    const PATTERN_REPLACER *replacer = state->replacer;
+    const int reach = replacer->maxMatchLen - 1;
+    from = from - reach < 0 ? 0 : from - reach;
+    to = to + reach > state->len ? state->len : to + reach;
+    if (from >= to)
+        return;
+
+    PATTERN_MATCH found[REPLACER_MAX_MATCHES];
+    REPLACER_SPAN spans[REPLACER_MAX_MATCHES];
+    int noFound = matchAll(&replacer->matcher, state->text + from, to - from,
+        found, REPLACER_MAX_MATCHES);
+    if (noFound > REPLACER_MAX_MATCHES)
+        noFound = REPLACER_MAX_MATCHES;
+
+    // Sorted into the order replacing each pattern in turn would find them
+    int noSpans = 0;
+    for (int i = 0; i < noFound; i++)
+    {
+        if (found[i].pattern <= state->current)
+            continue;
+
+        REPLACER_SPAN span = { found[i].pattern, from + found[i].end -
+            replacer->entries[found[i].pattern].matchLen,
+            from + found[i].end };
+        int at = noSpans++;
+        while (at > 0 && isSpanBefore(&span, &spans[at - 1]))
+        {
+            spans[at] = spans[at - 1];
+            at--;
+        }
+        spans[at] = span;
+    }
+
+    for (int i = 0; i < noSpans; i++)
+    {
+        int isPending = 0;
+        for (int j = 0; j < state->noPending && !isPending; j++)
+            isPending = state->pending[j].pattern == spans[i].pattern &&
+                state->pending[j].start == spans[i].start;
+        if (!isPending)
+            considerSpan(state, spans[i]);
+    }
+}
+
+/**
+ * Replaces a match in the string, moving the matches after it to suit.
+ * @param state String being rewritten
+ * @param span Match to replace
+ * @return Offset just past the end of the replacement text
+ */
+static int replaceSpan(REPLACER_STATE *state, const REPLACER_SPAN span)
+{
+    const REPLACER_ENTRY *entry = &state->replacer->entries[span.pattern];
+    int replacementLen = entry->replacementLen;
+    if (span.start + replacementLen > state->size - 1)
+        replacementLen = state->size - 1 - span.start;
+    int end = span.start + replacementLen;
+    int tailLen = state->len - span.end;
+    if (end + tailLen > state->size - 1)
+        tailLen = state->size - 1 - end;
+
+    memmove(state->text + end, state->text + span.end, tailLen);
+    memcpy(state->text + span.start, entry->replacement, replacementLen);
+    state->len = end + tailLen;
+    state->text[state->len] = '\0';
+
+    // Matches are never replaced across each other, so the rest are either
+    // wholly before this one or wholly after it (unless cut off)
+    int kept = 0;
+    for (int i = 0; i < state->noPending; i++)
+    {
+        REPLACER_SPAN other = state->pending[i];
+        if (other.start >= span.end)
+        {
+            other.start += end - span.end;
+            other.end += end - span.end;
+        }
+        if (other.end <= state->len)
+            state->pending[kept++] = other;
+    }
+    state->noPending = kept;
+
+    return end;
+}
+
+#ifndef NO_STR_CLEANING
+
+/**
+ * Compiles one of the REPLACEMENT tables in replacements.h.
+ * @param table Which table it is
+ * @param replaces The table
+ * @param count Number of replacements in the table
+ */
+static void buildReplacementTable(const REPLACER_TABLE table,
+    const struct REPLACEMENT *replaces, const int count)
+{
+    const char *matches[count];
+    const char *replacements[count];
+    int standalone[count];
+    for (int i = 0; i < count; i++)
+    {
+        matches[i] = replaces[i].match;
+        replacements[i] = replaces[i].replacement;
+        standalone[i] = replaces[i].standalone;
+    }
+    buildReplacer(&REPLACERS[table], matches, replacements, standalone, count);
+}
+
+/**
+ * Compiles every table in replacements.h.
+ */
+static void buildReplacers(void)
+{
+    buildReplacementTable(REPLACER_AMD, AMD_REPLACES, AMD_REPLACES_LEN);
+    buildReplacementTable(REPLACER_COMPACT_CPU, COMPACT_CPU_REPLACES,
+        COMPACT_CPU_REPLACES_LEN);
+    buildReplacementTable(REPLACER_COMPACT_GPU, COMPACT_GPU_REPLACES,
+        COMPACT_GPU_REPLACES_LEN);
+    buildReplacementTable(REPLACER_COMPACT_OS, COMPACT_OS_REPLACES,
+        COMPACT_OS_REPLACES_LEN);
+    buildReplacer(&REPLACERS[REPLACER_DELETIONS], DELETIONS, NULL, NULL,
+        DELETIONS_LEN);
+    buildReplacementTable(REPLACER_IDT, IDT_REPLACES, IDT_REPLACES_LEN);
+    buildReplacementTable(REPLACER_INTEL, INTEL_REPLACES, INTEL_REPLACES_LEN);
+    buildReplacementTable(REPLACER_VIA, VIA_REPLACES, VIA_REPLACES_LEN);
+}
+
+#endif
+
+
+
+/**
+ * Compiles a table of replacements into a replacer.
+ * @param replacer Replacer to build into
+ * @param matches Table of patterns to replace
+ * @param replacements Text to replace each pattern with, which must outlive
+ *                     the replacer; NULL to delete every pattern
+ * @param standalone Flags if each pattern is only replaced when no pattern
+ *                   before it has been; NULL if none are
+ * @param count Number of patterns in the table
+ * @return 1 if successful; 0 if out of memory (the replacer then replaces
+ *         nothing)
+ */
+int buildReplacer(PATTERN_REPLACER *replacer, const char *const *matches,
+    const char *const *replacements, const int *standalone, const int count)
+{
+    replacer->count = 0;
+    replacer->maxMatchLen = 0;
+    replacer->entries = malloc((count > 0 ? count : 1) *
+        sizeof(REPLACER_ENTRY));
+    if (!replacer->entries)
+    {
+        replacer->matcher = (PATTERN_MATCHER){ NULL, 0, NULL, NULL };
+        return 0;
+    }
+    if (!buildMatcher(&replacer->matcher, matches, count))
+    {
+        freeReplacer(replacer);
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        REPLACER_ENTRY *entry = &replacer->entries[i];
+        entry->replacement = replacements && replacements[i] ?
+            replacements[i] : "";
+        entry->matchLen = matches[i] ? strlen(matches[i]) : 0;
+        entry->replacementLen = strlen(entry->replacement);
+        entry->standalone = standalone ? standalone[i] : 0;
+        if (entry->matchLen > replacer->maxMatchLen)
+            replacer->maxMatchLen = entry->matchLen;
+    }
+    replacer->count = count;
+    return 1;
+}
+
+/**
+ * Frees the memory used by a replacer.
+ * @param replacer Replacer to free
+ */
+void freeReplacer(PATTERN_REPLACER *replacer)
+{
+    freeMatcher(&replacer->matcher);
+    free(replacer->entries);
+    replacer->entries = NULL;
+    replacer->count = 0;
+    replacer->maxMatchLen = 0;
+}
+
+/**
+ * Rewrites a string with every replacement in a replacer's table, the same
+ * as replacing every occurrence of each pattern in table order would. The
+ * string is scanned once for every pattern, then matches are replaced in
+ * table order, with only the text around each replacement scanned again for
+ * the matches it makes or unblocks (e.g. " 486 DX" becoming " i486DX" ahead
+ * of "486DX/2").
+ * @param replacer Replacer to use
+ * @param input Input string
+ * @param output Buffer to write the result to (may be the input string's
+ *               own buffer)
+ * @param outputSize Size of the output buffer; the result is cut short to
+ *                   fit it
+ * @return Number of replacements made
+ */
+int replaceAll(const PATTERN_REPLACER *replacer, const char *input,
+    char *output, const int outputSize)
+{
+    if (!output || outputSize < 1)
+        return 0;
+    if (!input)
+        input = "";
+
+    REPLACER_STATE state;
+    state.replacer = replacer;
+    state.text = output;
+    state.len = strnlen(input, outputSize - 1);
+    state.size = outputSize;
+    state.noPending = 0;
+    state.current = -1;
+    state.lowest = replacer->count;
+    memmove(output, input, state.len);
+    output[state.len] = '\0';
+
+    int replaces = 0;
+    considerWindow(&state, 0, state.len);
+    while (state.noPending > 0)
+    {
+        REPLACER_SPAN span = state.pending[0];
+        state.noPending--;
+        memmove(state.pending, state.pending + 1,
+            state.noPending * sizeof(REPLACER_SPAN));
+        if (replacer->entries[span.pattern].standalone &&
+            state.lowest < span.pattern)
+            continue;
+
+        int end = replaceSpan(&state, span);
+        replaces++;
+        state.current = span.pattern;
+        if (span.pattern < state.lowest)
+            state.lowest = span.pattern;
+        considerWindow(&state, span.start, end);
+    }
+
+    return replaces;
+}
+
+#ifndef NO_STR_CLEANING
+
+/**
+ * @param table Table in replacements.h to get
+ * @return Replacer for the table, compiled on first use
+ */
+const PATTERN_REPLACER *getReplacer(const REPLACER_TABLE table)
+{
+    pthread_once(&REPLACERS_ONCE, buildReplacers);
+    return &REPLACERS[table];
+}
+
+#endif
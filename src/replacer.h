@@ -0,0 +1,76 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Functions and data relating to rewriting a       ##
+    ## string with a table of replacements in a single  ##
+    ## pass                                             ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#ifndef REPLACER
+#define REPLACER
+
+#include "matcher.h"
+
+// Most matches a string is searched for at once; any past this are left as
+// they are (names are far too short to ever have this many)
+#define REPLACER_MAX_MATCHES    256
+
+
+
+typedef struct {
+    // Text that replaces the pattern ("" to delete it)
+    const char *replacement;
+    int matchLen;
+    int replacementLen;
+    // Flags if the pattern is only replaced when no pattern before it in the
+    // table has been
+    int standalone;
+} REPLACER_ENTRY;
+
+// A table of replacements compiled into a matcher, which rewrites a string
+// the same as replacing every occurrence of each pattern in table order would
+typedef struct {
+    PATTERN_MATCHER matcher;
+    REPLACER_ENTRY *entries;
+    int count;
+    // Longest pattern, which bounds how far a match can reach
+    int maxMatchLen;
+} PATTERN_REPLACER;
+
+#ifndef NO_STR_CLEANING
+
+// Tables in replacements.h that getReplacer compiles
+typedef enum
+{
+    REPLACER_AMD,
+    REPLACER_COMPACT_CPU,
+    REPLACER_COMPACT_GPU,
+    REPLACER_COMPACT_OS,
+    REPLACER_DELETIONS,
+    REPLACER_IDT,
+    REPLACER_INTEL,
+    REPLACER_VIA,
+    REPLACER_TABLES_LEN
+} REPLACER_TABLE;
+
+#endif
+
+
+
+int buildReplacer(PATTERN_REPLACER *, const char *const *,
+    const char *const *, const int *, const int);
+void freeReplacer(PATTERN_REPLACER *);
+int replaceAll(const PATTERN_REPLACER *, const char *, char *, const int);
+#ifndef NO_STR_CLEANING
+const PATTERN_REPLACER *getReplacer(const REPLACER_TABLE);
+#endif
+
+#endif
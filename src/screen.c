@@ -12,8 +12,10 @@
 
 
 
+#include "arena.h"
 #include "general.h"
 #include "globals.h"
+#include "io.h"
 #include "screen.h"
 
 #include <dirent.h>
@@ -40,7 +42,7 @@ Screen *getScreens(int *count)
     Screen *screens = NULL;
 
     // Try getting screens with xrandr (X11)
-    FILE *fStream = popen("xrandr --current 2>/dev/null", "r");
+    FILE *fStream = openProgram("xrandr --current 2>/dev/null");
     if (fStream)
     {
         // What we use to read lines of xrandr output in to
@@ -146,7 +148,7 @@ Screen *getScreens(int *count)
     // fallback
     if (!screens)
     {
-        DIR *dirStream = opendir("/sys/class/drm");
+        DIR *dirStream = openDir("/sys/class/drm");
 
         if (dirStream)
         {
@@ -162,7 +164,7 @@ Screen *getScreens(int *count)
                 snprintf(path, PATH_MAX, "/sys/class/drm/%s/status",
                     entry->d_name);
 
-                FILE *fileStream = fopen(path, "r");
+                FILE *fileStream = openFile(path, "r");
                 if (!fileStream)
                     continue;
 
@@ -178,7 +180,7 @@ Screen *getScreens(int *count)
                 // Prepare to parse mode for resolution
                 snprintf(path, PATH_MAX, "/sys/class/drm/%s/modes",
                     entry->d_name);
-                fileStream = fopen(path, "r");
+                fileStream = openFile(path, "r");
                 if (!fileStream)
                     continue;
 
@@ -235,16 +237,18 @@ Screen *getScreens(int *count)
 /**
  * @param screen Screen struct containing raw specifications for the given
  *               screen
- * @return String containing the screen's assembled specifications
+ * @param arena Arena to allocate the result from
+ * @return String containing the screen's assembled specifications; NULL if
+ *         there are none or out of memory
  */
-char *interpretScreen(Screen *screen)
+char *interpretScreen(MEM_ARENA *arena, Screen *screen)
 {
     // Quick check to make sure we have something to work with...
     if (screen->resX <= 0 || screen->resY <= 0)
         return NULL;
 
     const int SCREEN_SIZE = 128;
-    char *screenStr = malloc(SCREEN_SIZE);
+    char *screenStr = arenaAlloc(arena, SCREEN_SIZE);
 
     // Prepare physical screen size (NOT PRESENTLY USED PENDING ACCURACY
     // IMPROVEMENTS)
@@ -15,6 +15,8 @@
 #ifndef SCREEN
 #define SCREEN
 
+#include "arena.h"
+
 typedef struct {
     // Connector name (e.g., DP-1)
     char *connector;
@@ -35,6 +37,6 @@ typedef struct {
 
 
 Screen *getScreens(int*);
-char *interpretScreen(Screen*);
+char *interpretScreen(MEM_ARENA *, Screen*);
 
 #endif
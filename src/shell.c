@@ -13,6 +13,7 @@
 
 
 
+#include "arena.h"
 #include "shell.h"
 
 #include <libgen.h>
@@ -22,15 +23,14 @@
 
 
 /**
+ * @param arena Arena to allocate the result from
  * @return String containing the shell's name or "unknown" if
- *         undetermined/error
+ *         undetermined/error; NULL if out of memory
  */
-char *getShell(void)
+char *getShell(MEM_ARENA *arena)
 {
     char *shell = getenv("SHELL");
     if (!shell || shell[0] == '\0') 
-        shell = strdup("unknown");
-    else
-        shell = strdup(basename(shell));
-    return shell;
+        return arenaStrdup(arena, "unknown");
+    return arenaStrdup(arena, basename(shell));
 }
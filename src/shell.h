@@ -16,6 +16,10 @@
 #ifndef SHELL
 #define SHELL
 
-char *getShell(void);
+#include "arena.h"
+
+
+
+char *getShell(MEM_ARENA *);
 
 #endif
@@ -13,6 +13,7 @@
 
 
 
+#include "arena.h"
 #include "exclusions.h"
 #include "general.h"
 #include "globals.h"
@@ -26,10 +27,11 @@
 
 
 /**
+ * @param arena Arena to allocate the result from
  * @return String containing the host terminal emulator's name; NULL if not
  *         found/applicable
  */
-char *getTerminal(void)
+char *getTerminal(MEM_ARENA *arena)
 {
     // If we don't think we're in a graphical environment, time to leave...
     if (!WAYLAND_PRESENT && !X11_PRESENT)
@@ -40,7 +42,7 @@ char *getTerminal(void)
     // Try the easy way ($TERM_PROGRAM) first
     char *termProgram = getenv("TERM_PROGRAM");
     if (termProgram && termProgram[0] != '\0')
-        terminal = strdup(termProgram);
+        terminal = arenaStrdup(arena, termProgram);
 
     // Try looking through our parent processes to get the name
     if (!terminal)
@@ -72,7 +74,7 @@ char *getTerminal(void)
 
             if (!notTerminal)
             {
-                terminal = strdup(process.name);
+                terminal = arenaStrdup(arena, process.name);
                 break;
             }
 
@@ -87,11 +89,11 @@ char *getTerminal(void)
         const char *TERM = getenv("TERM");
         if (TERM && TERM[0] != '\0')
         {
-            if (COMPACT) terminal = strdup(TERM);
+            if (COMPACT) terminal = arenaStrdup(arena, TERM);
             else
             {
                 int termLen = strlen(TERM) + 11 + 1;
-                terminal = malloc(termLen);
+                terminal = arenaAlloc(arena, termLen);
                 if (terminal)
                     snprintf(terminal, termLen, "%s compatible", TERM);
             }
@@ -16,6 +16,10 @@
 #ifndef TERMINAL
 #define TERMINAL
 
-char *getTerminal(void);
+#include "arena.h"
+
+
+
+char *getTerminal(MEM_ARENA *);
 
 #endif
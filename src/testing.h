@@ -15,7 +15,9 @@
 
 #ifdef TESTS
 
+#include "arena.h"
 #include "cpu.h"
+#include "cpurules.h"
 #include "gpu.h"
 
 #include <ctype.h>
@@ -174,22 +176,56 @@ void testGetCPU(void)
             printf("    cores:              %d\n", cpu->cores);
             printf("    threads:            %d\n", cpu->threads);
             printf("    cacheSize:          %d\n", cpu->cacheSize);
-            printf("    flags:              %s\n", cpu->flags);
+            printf("    flags:             ");
+            for (int i = 0; i < CPU_FLAGS_LEN; i++)
+                if (hasFlag(cpu, i))
+                    printf(" %s", CPU_FLAG_NAMES[i]);
+            printf("%s%s\n", cpu->otherFlags ? " " : "",
+                cpu->otherFlags ? cpu->otherFlags : "");
+            char *isa = interpretISA(cpu);
+            printf("    isa:                %s\n", isa ? isa : "(null)");
+            free(isa);
             printf("    physAddrSize:       %d\n", cpu->physAddrSize);
             printf("    virtAddrSize:       %d\n", cpu->virtAddrSize);
         }
 
-#ifndef X86_ONLY
-        free(cpu->processor);
-        free(cpu->uarch);
-        free(cpu->platform);
-        free(cpu->machine);
-#endif
-        free(cpu->vendor);
-        free(cpu->name);
-        free(cpu);
+        freeCPU(cpu);
         free(gpuFromCPU);
     }
+
+    // CPU_RULES are binary searched, so must stay sorted; rules that no
+    // example hits may be wrong or need a new example
+    for (int i = 1; i < CPU_RULES_LEN; i++)
+    {
+        const CPU_RULE *prev = &CPU_RULES[i - 1], *rule = &CPU_RULES[i];
+        if (prev->vendor > rule->vendor || (prev->vendor == rule->vendor &&
+            (prev->family > rule->family || (prev->family == rule->family &&
+            prev->modelMin > rule->modelMin))))
+            printf("\033[31mCPU_RULES[%d] is out of order\033[0m\n", i);
+    }
+    const char *vendors[] = { "other", "AMD", "Centaur", "Cyrix", "Intel" };
+    for (int i = 0; i < CPU_RULES_LEN; i++)
+    {
+        if (CPU_RULE_HITS[i] != 0)
+            continue;
+
+        // Identify the rule by the CPUs it is for, as APPEND rules' text
+        // (e.g. " (Argon)") says little on its own
+        const CPU_RULE *rule = &CPU_RULES[i];
+        char model[32] = "any";
+        if (rule->modelMin == CPU_RULE_ANY && rule->modelMax != CPU_RULE_ANY)
+            snprintf(model, sizeof(model), "up to %d", rule->modelMax);
+        else if (rule->modelMin != CPU_RULE_ANY &&
+            rule->modelMax == CPU_RULE_ANY)
+            snprintf(model, sizeof(model), "%d+", rule->modelMin);
+        else if (rule->modelMin != rule->modelMax)
+            snprintf(model, sizeof(model), "%d-%d", rule->modelMin,
+                rule->modelMax);
+        else if (rule->modelMin != CPU_RULE_ANY)
+            snprintf(model, sizeof(model), "%d", rule->modelMin);
+        printf("\033[33mCPU_RULES[%d] (%s family %d model %s) was not "
+            "hit\033[0m\n", i, vendors[rule->vendor], rule->family, model);
+    }
 }
 
 /**
@@ -207,121 +243,141 @@ void testInterpretGPU(void)
             "ATI 68800AX [Graphics Ultra Pro PCI]",
             0x1002,
             0x4158,
-            0x00
+            0x00,
+            ""
         },
         {
             "ATI FirePro V (FireGL V) Graphics Adapter",
             0x1002,
             0x6784,
-            0x00
+            0x00,
+            ""
         },
         {
             "Caicos [Radeon HD 6450/7450/8450 / R5 230 OEM]",
             0x1002,
             0x6779,
-            -1
+            -1,
+            ""
         },
         {
             "Tahiti XT GL [FirePro W9000]",
             0x1002,
             0x6780,
-            -1
+            -1,
+            ""
         },
         {
             "Tahiti XT GL [FirePro W9000]",
             0x1002,
             0x6780,
-            0x00
+            0x00,
+            ""
         },
         {
             "Tahiti [FirePro Series Graphics Adapter]",
             0x1002,
             0x6784,
-            -1
+            -1,
+            ""
         },
         {
             "Navi 33 [Radeon RX 7600/7600 XT/7600M XT/7600S/7700S / PRO W7600]",
             0x1002,
             0x7480,
-            -1
+            -1,
+            ""
         },
         {
             "Navi 33 [Radeon RX 7600/7600 XT/7600M XT/7600S/7700S / PRO W7600]",
             0x1002,
             0x7480, 
-            0xC1
+            0xC1,
+            ""
         },
         {
             "NV11 [GeForce2 MX/MX 400]",
             0x10de,
             0x0110,
-            -1
+            -1,
+            ""
         },
         {
             "NV43M [GeForce Go6200 TE / 6600 TE]",
             0x10de,
             0x0146,
-            -1
+            -1,
+            ""
         },
         {
             "G92GLM [Quadro FX 3700M]",
             0x10de,
             0x061e,
-            -1
+            -1,
+            ""
         },
         {
             "G94 [GeForce 9600 GT Green Edition]",
             0x10de,
             0x0624,
-            -1
+            -1,
+            ""
         },
         {
             "G96 [GeForce 9500 GA / 9600 GT / GTS 250]",
             0x10de,
             0x065d,
-            -1
+            -1,
+            ""
         },
         {
             "GF110 [GeForce GTX 560 Ti OEM]",
             0x10de,
             0x1082,
-            -1
+            -1,
+            ""
         },
         {
             "GF110 [GeForce GTX 560 Ti 448 Cores]",
             0x10de,
             0x1087,
-            -1
+            -1,
+            ""
         },
         {
             "GM204M [GeForce GTX 960 OEM / 970M]",
             0x10de,
             0x13d8,
-            -1
+            -1,
+            ""
         },
         {
             "GM204 [GeForce GTX 980]",
             0x10de,
             0x13c0,
-            0xa1
+            0xa1,
+            ""
         },
         {
             "TU104GLM [Quadro RTX 5000 Mobile / Max-Q]",
             0x10de,
             0x1eb5,
-            -1
+            -1,
+            ""
         },
         {
             "TU106 [GeForce RTX 2070 Rev. A]",
             0x10de,
             0x1f07,
-            -1
+            -1,
+            ""
         },
         {
             "AD103 [GeForce RTX 4080 SUPER]",
             0x10de,
             0x2702,
-            -1
+            -1,
+            ""
         }
     };
     const int noGPUs = sizeof(gpus) / sizeof(gpus[0]);
@@ -340,6 +396,78 @@ void testInterpretGPU(void)
     }
 }
 
+/**
+ * Tests the interpretISA function to ensure it only reports the levels and
+ * SIMD tiers the CPU's flags allow, including when the kernel has left AVX
+ * out of them (e.g. the OS has not enabled AVX's registers).
+ */
+void testInterpretISA(void)
+{
+    printf("########################\n");
+    printf("## INTERPRET ISA TEST ##\n");
+    printf("########################\n");
+
+    struct {
+        const char *flags;
+        const char *expected;
+        const char *compactExpected;
+    } tests[] = {
+        // Pentium III
+        { "fpu tsc cx8 cmov mmx fxsr sse", "SSE", "SSE" },
+        // Athlon 64
+        { "fpu tsc cx8 cmov mmx fxsr sse sse2 syscall nx lm",
+            "x86-64 (SSE2)", "x86-64" },
+        // Haswell with AVX hidden by the kernel (e.g. noxsave)
+        { "fpu tsc cx8 cmov mmx fxsr sse sse2 syscall nx lm pni ssse3 cx16 "
+            "sse4_1 sse4_2 movbe popcnt aes lahf_lm abm bmi1 bmi2",
+            "x86-64-v2 (SSE4.2)", "x86-64-v2" },
+        // Haswell
+        { "fpu tsc cx8 cmov mmx fxsr sse sse2 syscall nx lm pni ssse3 fma "
+            "cx16 sse4_1 sse4_2 movbe popcnt aes xsave avx f16c lahf_lm abm "
+            "bmi1 avx2 bmi2", "x86-64-v3 (AVX2)", "x86-64-v3" },
+        // Knights Landing, whose AVX-512 lacks what x86-64-v4 needs
+        { "fpu tsc cx8 cmov mmx fxsr sse sse2 syscall nx lm pni ssse3 fma "
+            "cx16 sse4_1 sse4_2 movbe popcnt aes xsave avx f16c lahf_lm abm "
+            "bmi1 avx2 bmi2 avx512f avx512cd", "x86-64-v3 (AVX-512)",
+            "x86-64-v3" },
+        // Skylake-SP
+        { "fpu tsc cx8 cmov mmx fxsr sse sse2 syscall nx lm pni ssse3 fma "
+            "cx16 sse4_1 sse4_2 movbe popcnt aes xsave avx f16c lahf_lm abm "
+            "bmi1 avx2 bmi2 avx512f avx512dq avx512cd avx512bw avx512vl",
+            "x86-64-v4 (AVX-512)", "x86-64-v4" },
+        // No flags at all
+        { "", NULL, NULL }
+    };
+    const int noTests = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < noTests; i++)
+    {
+        CPU_DATA cpu;
+        memset(&cpu, 0, sizeof(cpu));
+        cpu.arch = X86;
+
+        char flags[512];
+        snprintf(flags, sizeof(flags), "%s", tests[i].flags);
+        char *save = NULL;
+        for (char *flag = strtok_r(flags, " ", &save); flag;
+            flag = strtok_r(NULL, " ", &save))
+            for (int j = 0; j < CPU_FLAG_NAMES_LEN; j++)
+                if (strcmp(CPU_FLAG_NAMES[j], flag) == 0)
+                    setFlag(&cpu, j);
+
+        const char *expected = COMPACT ? tests[i].compactExpected :
+            tests[i].expected;
+        char *isa = interpretISA(&cpu);
+        if ((!isa && !expected) || (isa && expected &&
+            strcmp(isa, expected) == 0))
+            printf("%d: \033[32m%s\033[0m\n", i, isa ? isa : "(null)");
+        else
+            printf("%d: \033[31m%s\033[0m (expected %s)\n", i,
+                isa ? isa : "(null)", expected ? expected : "(null)");
+        free(isa);
+    }
+}
+
 /**
  * Tests the interpretScreen function to ensure it assembles screen specs
  * strings as we expect it to.
@@ -424,15 +552,17 @@ void testInterpretScreen(void)
     };
     const int noScreens = sizeof(screens) / sizeof(screens[0]);
 
+    MEM_ARENA arena;
+    initArena(&arena);
     for (int i = 0; i < noScreens; i++)
     {
-        char *screen = interpretScreen(&screens[i]);
+        char *screen = interpretScreen(&arena, &screens[i]);
         float diagMm = fSqrt(screens[i].physX * screens[i].physX + screens[i].physY * screens[i].physY);
         float diagIn = (float)diagMm / 25.4f;
         if (screen && screen[0] != '\0')
             printf("\033[31m%f\"\033[0m -> \033[32m%s\033[0m\n", diagIn, screen);
-        free(screen);
     }
+    freeArena(&arena);
 }
 
 #endif
@@ -13,25 +13,28 @@
 
 
 
+#include "arena.h"
 #include "globals.h"
+#include "io.h"
 
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 #include <sys/utsname.h>
 
 
 
 /**
- * @return String containing uptime or "unknown" if undetermined/error
+ * @param arena Arena to allocate the result from
+ * @return String containing uptime or "unknown" if undetermined/error; NULL
+ *         if out of memory
  */
-char *getUptime(void)
+char *getUptime(MEM_ARENA *arena)
 {
-    char *uptime = malloc(128);
-    if (!uptime) return strdup("unknown");
+    char *uptime = arenaAlloc(arena, 128);
+    if (!uptime) return NULL;
     uptime[0] = '\0'; 
 
-    FILE *fStream = fopen("/proc/uptime", "r");
+    FILE *fStream = openFile("/proc/uptime", "r");
     if (fStream)
     {
         double seconds;
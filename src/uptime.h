@@ -16,6 +16,10 @@
 #ifndef UPTIME
 #define UPTIME
 
-char *getUptime(void);
+#include "arena.h"
+
+
+
+char *getUptime(MEM_ARENA *);
 
 #endif
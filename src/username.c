@@ -13,21 +13,24 @@
 
 
 
+#include "arena.h"
+#include "username.h"
+
 #include <stdlib.h>
-#include <string.h>
 
 
 
 /**
- * @return String containing the current username;"unknown" if undetermined/
- *         error
+ * @param arena Arena to allocate the result from
+ * @return String containing the current username; "unknown" if
+ *         undetermined/error; NULL if out of memory
  */
-char *getUsername(void)
+char *getUsername(MEM_ARENA *arena)
 {
     char *username = getenv("USER");
     if (!username || username[0] == '\0')
         username = getenv("LOGNAME");
     if (!username || username[0] == '\0') 
-        username = strdup("unknown");
-    return username;
+        return arenaStrdup(arena, "unknown");
+    return arenaStrdup(arena, username);
 }
@@ -16,6 +16,10 @@
 #ifndef USERNAME
 #define USERNAME
 
-char *getUsername(void);
+#include "arena.h"
+
+
+
+char *getUsername(MEM_ARENA *);
 
 #endif
@@ -0,0 +1,343 @@
+/*
+    ######################################################
+    ##            SHORK UTILITY - SHORKFETCH            ##
+    ######################################################
+    ## Generates the GPU database built into SHORKFETCH ##
+    ## by EMBED_GPU_DB=1 from a copy of pci.ids         ##
+    ######################################################
+    ## Licence: GNU GENERAL PUBLIC LICENSE Version 3    ##
+    ######################################################
+    ## Kali (links.sharktastica.co.uk)                  ##
+    ######################################################
+*/
+
+
+
+#include "src/globals.h"
+#include "src/gpu.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+typedef struct {
+    int vendor;
+    // Flags if every device (that is not excluded) is a display device, else
+    // only devices named like one are
+    int allDevices;
+} GPUDB_VENDOR;
+
+typedef struct {
+    unsigned int id;
+    char *name;
+    char *compactName;
+    // Offsets of the names in the generated name pool
+    int nameAt;
+    int compactNameAt;
+} GPUDB_ENTRY;
+
+typedef struct {
+    const char *name;
+    GPUDB_ENTRY *entry;
+    int compact;
+} GPUDB_NAME;
+
+
+
+// pci.ids does not record device classes, so display devices are picked out
+// by vendor, and by name for vendors that mostly make other things
+static const GPUDB_VENDOR GPUDB_VENDORS[] = {
+    { 0x0e11, 0 },  // Compaq
+    { 0x1002, 1 },  // AMD/ATI
+    { 0x100c, 1 },  // Tseng Labs
+    { 0x1013, 1 },  // Cirrus Logic
+    { 0x1023, 1 },  // Trident
+    { 0x102b, 1 },  // Matrox
+    { 0x102c, 1 },  // Chips and Technologies
+    { 0x1039, 0 },  // SiS
+    { 0x105d, 1 },  // Number Nine
+    { 0x1106, 0 },  // VIA
+    { 0x10de, 1 },  // NVIDIA
+    { 0x121a, 1 },  // 3Dfx
+    { 0x1163, 1 },  // Rendition
+    { 0x1234, 1 },  // QEMU
+    { 0x1414, 0 },  // Microsoft (Hyper-V)
+    { 0x15ad, 0 },  // VMware
+    { 0x18ca, 1 },  // XGI
+    { 0x1a03, 0 },  // ASPEED
+    { 0x1af4, 0 },  // Red Hat (virtio)
+    { 0x1b36, 0 },  // Red Hat (QXL)
+    { 0x3d3d, 1 },  // 3Dlabs
+    { 0x5333, 1 },  // S3
+    { 0x80ee, 0 },  // VirtualBox
+    { 0x8086, 0 }   // Intel
+};
+static const int GPUDB_VENDORS_LEN = sizeof(GPUDB_VENDORS) /
+    sizeof(GPUDB_VENDORS[0]);
+
+// Device names that mark a display device (matched case-insensitively)
+static const char *GPUDB_DISPLAY_WORDS[] = {
+    "Graphic",
+    "GPU",
+    "VGA",
+    "Display",
+    "Video",
+    "GMA",
+    "Iris",
+    "Arc ",
+    "QVision",
+    "SVGA"
+};
+static const int GPUDB_DISPLAY_WORDS_LEN = sizeof(GPUDB_DISPLAY_WORDS) /
+    sizeof(GPUDB_DISPLAY_WORDS[0]);
+
+// Device names that mark anything else, even from display vendors
+static const char *GPUDB_OTHER_WORDS[] = {
+    "Audio",
+    "Bridge",
+    "Bluetooth",
+    "Ethernet",
+    "Host",
+    "IDE",
+    "IOMMU",
+    "LPC",
+    "Modem",
+    "Network",
+    "RAID",
+    "Root Port",
+    "SATA",
+    "SMBus",
+    "Serial",
+    "USB",
+    "Wireless"
+};
+static const int GPUDB_OTHER_WORDS_LEN = sizeof(GPUDB_OTHER_WORDS) /
+    sizeof(GPUDB_OTHER_WORDS[0]);
+
+
+
+/**
+ * @param vendor Vendor ID
+ * @return The vendor's GPUDB_VENDORS entry; NULL if it makes no GPUs
+ */
+static const GPUDB_VENDOR *findVendor(const int vendor)
+{
+    for (int i = 0; i < GPUDB_VENDORS_LEN; i++)
+        if (GPUDB_VENDORS[i].vendor == vendor)
+            return &GPUDB_VENDORS[i];
+    return NULL;
+}
+
+/**
+ * @param vendor The device's vendor's GPUDB_VENDORS entry
+ * @param name Device's name in pci.ids
+ * @return 1 if the device is a display device; 0 if not
+ */
+static int isDisplayDevice(const GPUDB_VENDOR *vendor, const char *name)
+{
+    for (int i = 0; i < GPUDB_OTHER_WORDS_LEN; i++)
+        if (strstr(name, GPUDB_OTHER_WORDS[i]))
+            return 0;
+    if (vendor->allDevices)
+        return 1;
+
+    for (int i = 0; i < GPUDB_DISPLAY_WORDS_LEN; i++)
+        if (strcasestr(name, GPUDB_DISPLAY_WORDS[i]))
+            return 1;
+    return 0;
+}
+
+/**
+ * Cleans a name the same way interpretGPU does, in normal or compact mode.
+ * @return String containing the cleaned name, cut to GPU_NAME_LEN
+ */
+static char *cleanName(const char *vendor, const char *device,
+    const int compact)
+{
+    COMPACT = compact;
+    char *name = cleanGPUName(vendor, device, 0);
+    if (name && strlen(name) >= GPU_NAME_LEN)
+        name[GPU_NAME_LEN - 1] = '\0';
+    return name;
+}
+
+/**
+ * @param name Cleaned name
+ * @return 1 if the name is usable; 0 if it is empty or its vendor resolved to
+ *         nothing (which glibc prints as "(null)")
+ */
+static int isNamed(const char *name)
+{
+    return name && name[0] != '\0' && name[0] != ' ' &&
+        !strstr(name, "(null)");
+}
+
+static int compareEntries(const void *a, const void *b)
+{
+    unsigned int idA = ((const GPUDB_ENTRY *)a)->id;
+    unsigned int idB = ((const GPUDB_ENTRY *)b)->id;
+    return (idA > idB) - (idA < idB);
+}
+
+static int compareNames(const void *a, const void *b)
+{
+    return strcmp(((const GPUDB_NAME *)a)->name,
+        ((const GPUDB_NAME *)b)->name);
+}
+
+/**
+ * Writes a string as a C string literal, followed by a terminator.
+ */
+static void printLiteral(const char *str)
+{
+    printf("    \"");
+    for (const char *c = str; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            putchar('\\');
+        putchar(*c);
+    }
+    printf("\\0\"\n");
+}
+
+
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s PCI_IDS > src/gpudb.gen.h\n", argv[0]);
+        return 1;
+    }
+
+    FILE *fStream = fopen(argv[1], "r");
+    if (!fStream)
+    {
+        fprintf(stderr, "ERROR: could not open %s\n", argv[1]);
+        return 1;
+    }
+
+    GPUDB_ENTRY *entries = NULL;
+    int entriesLen = 0, entriesCap = 0;
+    const GPUDB_VENDOR *vendor = NULL;
+    int vendorID = 0;
+    char vendorName[GPU_NAME_LEN] = "";
+    char line[512];
+    while (fgets(line, sizeof(line), fStream))
+    {
+        line[strcspn(line, "\n")] = '\0';
+        if (line[0] == 'C' && line[1] == ' ')
+            break;
+
+        unsigned int id;
+        char name[GPU_NAME_LEN];
+        if (line[0] != '\t' &&
+            sscanf(line, "%4x  %255[^\n]", &id, name) == 2)
+        {
+            vendor = findVendor(id);
+            vendorID = id;
+            snprintf(vendorName, GPU_NAME_LEN, "%s", name);
+        }
+        else if (vendor && line[0] == '\t' && line[1] != '\t' &&
+            sscanf(line + 1, "%4x  %255[^\n]", &id, name) == 2 &&
+            isDisplayDevice(vendor, name))
+        {
+            if (entriesLen == entriesCap)
+            {
+                entriesCap = entriesCap ? entriesCap * 2 : 1024;
+                entries = realloc(entries, entriesCap * sizeof(GPUDB_ENTRY));
+                if (!entries)
+                {
+                    fprintf(stderr, "ERROR: out of memory\n");
+                    return 1;
+                }
+            }
+
+            GPUDB_ENTRY *entry = &entries[entriesLen++];
+            entry->id = ((unsigned int)vendorID << 16) | id;
+            entry->name = cleanName(vendorName, name, 0);
+            entry->compactName = cleanName(vendorName, name, 1);
+
+            // Vendors cleanGPUName has no name for are left out rather than
+            // baked in broken
+            if (!isNamed(entry->name) || !isNamed(entry->compactName))
+            {
+                fprintf(stderr, "WARNING: skipping %04x:%04x, as vendor "
+                    "\"%s\" has no name in cleanGPUName\n", vendorID, id,
+                    vendorName);
+                free(entry->name);
+                free(entry->compactName);
+                entriesLen--;
+            }
+        }
+    }
+    fclose(fStream);
+
+    qsort(entries, entriesLen, sizeof(GPUDB_ENTRY), compareEntries);
+
+    // Identical names (common, as one product often has several IDs) are
+    // only stored once
+    GPUDB_NAME *names = malloc((entriesLen * 2 + 1) * sizeof(GPUDB_NAME));
+    if (!names)
+    {
+        fprintf(stderr, "ERROR: out of memory\n");
+        return 1;
+    }
+    int namesLen = 0;
+    for (int i = 0; i < entriesLen; i++)
+    {
+        names[namesLen++] = (GPUDB_NAME){ entries[i].name, &entries[i], 0 };
+        names[namesLen++] =
+            (GPUDB_NAME){ entries[i].compactName, &entries[i], 1 };
+    }
+    qsort(names, namesLen, sizeof(GPUDB_NAME), compareNames);
+
+    printf("// Generated by tools/gengpudb from %s; do not edit\n\n", argv[1]);
+    printf("static const char GPUDB_NAMES[] =\n");
+    int poolLen = 0, at = 0;
+    for (int i = 0; i < namesLen; i++)
+    {
+        if (i == 0 || strcmp(names[i].name, names[i - 1].name) != 0)
+        {
+            printLiteral(names[i].name);
+            at = poolLen;
+            poolLen += strlen(names[i].name) + 1;
+        }
+
+        if (names[i].compact)
+            names[i].entry->compactNameAt = at;
+        else
+            names[i].entry->nameAt = at;
+    }
+    printf("    \"\";\n\n");
+
+    const char *offsetType = poolLen <= 0xffff ? "unsigned short" :
+        "unsigned int";
+    printf("// (Vendor ID << 16) | device ID, sorted\n");
+    printf("static const unsigned int GPUDB_IDS[] = {");
+    for (int i = 0; i < entriesLen; i++)
+        printf("%s0x%08x,", i % 6 ? " " : "\n    ", entries[i].id);
+    printf("\n    0\n};\n");
+    printf("static const %s GPUDB_NAME_OFFSETS[] = {", offsetType);
+    for (int i = 0; i < entriesLen; i++)
+        printf("%s%d,", i % 10 ? " " : "\n    ", entries[i].nameAt);
+    printf("\n    0\n};\n");
+    printf("static const %s GPUDB_COMPACT_NAME_OFFSETS[] = {", offsetType);
+    for (int i = 0; i < entriesLen; i++)
+        printf("%s%d,", i % 10 ? " " : "\n    ", entries[i].compactNameAt);
+    printf("\n    0\n};\n");
+    printf("// Excludes the terminating entries above\n");
+    printf("static const int GPUDB_LEN = %d;\n", entriesLen);
+
+    for (int i = 0; i < entriesLen; i++)
+    {
+        free(entries[i].name);
+        free(entries[i].compactName);
+    }
+    free(entries);
+    free(names);
+
+    return 0;
+}